@@ -0,0 +1,133 @@
+/**
+ * Computes the difficulty metrics QA uses to rate a maze.
+ *
+ * All per-tile metrics are gathered in a single pass over the maze state. The maze is stored column by column,
+ * so the pass is split into bands of rows, each thread walking its rows column after column and reducing its own
+ * counters before they are merged. The solution length is the only metric which needs a walk through the maze,
+ * and is found separately, unless the engine already measured it while carving.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "common.h"
+#include "maze_data.h"
+#include "analysis.h"
+
+#define WALL_MASK 15
+
+// The rows are split into at most this many bands, so each thread carries the horizontal runs of its own rows.
+#define BAND_COUNT 64
+
+// How many of the 4 walls are missing, indexed by the wall bits of a tile.
+static const unsigned char openingCount[16] = {4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0};
+
+/**
+ * Stops the walk once it reaches the end tile.
+ */
+static int isEnd(void* context, size_t tile, long long depth) {
+    (void) depth;
+    return tile == *(const size_t*) context;
+}
+
+/**
+ * Walks the maze from the start tile until it reaches the end tile.
+ *
+ * @return The number of steps from the start tile to the end tile, or -1 if the end tile can't be reached.
+ */
+static long long solutionLength() {
+    int coords[2];
+    unsigned char* walk = (unsigned char*) calloc((size_t) mazeWidth * mazeHeight, sizeof(unsigned char));
+    if (walk == NULL) {
+        return -1;
+    }
+
+    getStartTile(coords);
+    size_t start = (size_t) coords[0] * mazeHeight + coords[1];
+    getEndTile(coords);
+    size_t end = (size_t) coords[0] * mazeHeight + coords[1];
+
+    long long depth = walkMaze(start, walk, isEnd, &end);
+    free(walk);
+    return depth;
+}
+
+/**
+ * Gathers every difficulty metric of the current maze.
+ * Tiles masked out of the maze are left out of every metric.
+ * <ul>
+ *  <li>Dead ends are tiles with exactly 3 walls.</li>
+ *  <li>Junctions are tiles with 3 or more openings.</li>
+ *  <li>The solution length is the number of steps from the start tile to the end tile.</li>
+ *  <li>The longest corridor is the longest straight run of connected tiles, measured in tiles.</li>
+ *  <li>The branching factor histogram counts the tiles by how many openings they have.</li>
+ * </ul>
+ *
+ * @param result Pointer to the struct the metrics get stored in.
+ */
+void analyzeMaze(struct MazeAnalysis* result) {
+    const unsigned char* cells = getMazeCells();
+    const int width = mazeWidth, height = mazeHeight;
+    const int bandCount = height < BAND_COUNT ? height : BAND_COUNT;
+
+    // The length of the horizontal run each row is in, as of the column being looked at.
+    // Counting the runs as the columns go by keeps the pass from striding across columns.
+    int* rowRuns = (int*) calloc(height, sizeof(int));
+    if (rowRuns == NULL) {
+        fprintf(stderr, "Not enough memory to analyze the maze\n");
+        exit(1);
+    }
+
+    long long histogram[5] = {0, 0, 0, 0, 0};
+    int longestCorridor = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:histogram[:5]) reduction(max:longestCorridor)
+    for (int band = 0; band < bandCount; band++) {
+        const int firstY = (int) ((long long) height * band / bandCount);
+        const int lastY = (int) ((long long) height * (band + 1) / bandCount);
+
+        for (int x = 0; x < width; x++) {
+            const unsigned char* column = cells + (size_t) x * height;
+
+            // The vertical run the band starts in may have begun in the band above.
+            int columnRun = 0;
+            if (firstY > 0) {
+                columnRun = 1;
+                while (!((column[firstY - columnRun] >> NORTH) & 1)) columnRun++;
+            }
+
+            for (int y = firstY; y < lastY; y++) {
+                // Masked out tiles are not part of the maze, even though all of their walls are set.
+                // Their neighbours keep the walls facing them, so no run carries on through them either.
+                if (maze_mask != NULL && !maze_mask[(size_t) x * height + y]) {
+                    continue;
+                }
+
+                unsigned char walls = column[y] & WALL_MASK;
+                histogram[openingCount[walls]]++;
+
+                // Each tile either starts a run or continues the one before it. Multiplying by the open wall
+                // instead of branching on it avoids a mispredicted branch on most tiles, as runs are short.
+                columnRun = columnRun * (~walls >> NORTH & 1) + 1;
+                rowRuns[y] = rowRuns[y] * (~walls >> WEST & 1) + 1;
+                if (columnRun > longestCorridor) longestCorridor = columnRun;
+                if (rowRuns[y] > longestCorridor) longestCorridor = rowRuns[y];
+            }
+        }
+    }
+    free(rowRuns);
+
+    // The backtracker already knows the solution length when it carves its way into the end tile.
+    long long knownLength = getSolutionLength();
+
+    result->deadEnds = histogram[1];
+    result->junctions = histogram[3] + histogram[4];
+    result->solutionLength = knownLength >= 0 ? knownLength : solutionLength();
+    result->longestCorridor = longestCorridor;
+    for (int i = 0; i < 5; i++) {
+        result->branchingFactor[i] = histogram[i];
+    }
+}
@@ -0,0 +1,22 @@
+/**
+ * Header file for the maze difficulty metrics.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_ANALYSIS_H
+#define MAZEGENERATOR_ANALYSIS_H
+
+struct MazeAnalysis {
+    long long deadEnds;
+    long long junctions;
+    long long solutionLength;
+    int longestCorridor;
+    long long branchingFactor[5];
+};
+
+void analyzeMaze(struct MazeAnalysis* result);
+
+#endif
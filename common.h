@@ -12,8 +12,6 @@
 #define LINUX_INCREASE_STACK_SIZE 0
 #define LINUX_STACK_SIZE 16
 
-#define PRINT_BRANCHES 2
-#define DEBUG_LEVEL 1
 #define PRINT_PARAMETER_SETUP 1
 #define INCLUDE_MAX_SIZE 0
 #define MAZE_MAX_SIZE 400
@@ -39,5 +37,13 @@ extern int mazeHeight;
 extern int randomBranchLimit;
 extern int use_colours;
 extern int print_all_branches;
+extern int analyze_maze;
+extern int far_end_tile;
+extern int validate_maze;
+extern int live_view_fps;
+extern int maze_topology;
+extern int maze_layers;
+extern unsigned char* maze_mask;
+extern int maze_engine;
 
 #endif
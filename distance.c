@@ -0,0 +1,143 @@
+/**
+ * Computes how many steps every tile is from a given tile.
+ *
+ * Every maze carved here is perfect, so there is exactly one path between two tiles, and the depth at which a depth
+ * first walk reaches a tile is already its distance. The walk needs no stack or visited set of its own: a tile is
+ * visited once it has a distance, and the way back is the one open neighbour that is a step closer to the source.
+ * It runs on one thread, as a breadth first frontier through a spanning tree stays under a thousand tiles even on
+ * multi-million tile mazes, which is too little work to split between threads.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "common.h"
+#include "maze_data.h"
+#include "distance.h"
+
+/**
+ * Creates a map of how many steps each tile is from the tile at the given coordinates.
+ * Tiles which can't be reached are given the distance DISTANCE_UNREACHED.
+ *
+ * The map is indexed the same way as getMazeCells(), and must be freed by the caller.
+ *
+ * @param x The 0-indexed column of the source tile.
+ * @param y The 0-indexed row of the source tile.
+ * @return Pointer to the distance map, or NULL if it could not be allocated.
+ */
+unsigned int* computeDistanceField(int x, int y) {
+    const unsigned char* cells = getMazeCells();
+    const long long tileCount = (long long) mazeWidth * mazeHeight;
+    const long long offsets[4] = {-1, mazeHeight, 1, -(long long) mazeHeight};
+
+    unsigned int* distances = (unsigned int*) malloc(tileCount * sizeof(unsigned int));
+    if (distances == NULL) {
+        return NULL;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < tileCount; i++) {
+        distances[i] = DISTANCE_UNREACHED;
+    }
+
+    const size_t source = (size_t) x * mazeHeight + y;
+    size_t current = source;
+    unsigned int depth = 0;
+    int next = 0;
+    distances[source] = 0;
+
+    while (1) {
+        const unsigned char walls = cells[current];
+
+        // The outer walls are never removed, so an open wall always leads to another tile.
+        while (next < 4 && (((walls >> next) & 1) || distances[current + offsets[next]] != DISTANCE_UNREACHED)) {
+            next++;
+        }
+        if (next < 4) {
+            current += offsets[next];
+            distances[current] = ++depth;
+            next = 0;
+            continue;
+        }
+        if (current == source) {
+            break;
+        }
+
+        // In a tree, the only open neighbour one step closer to the source is the parent.
+        int parent = 0;
+        while (((walls >> parent) & 1) || distances[current + offsets[parent]] != depth - 1) {
+            parent++;
+        }
+        current += offsets[parent];
+        depth--;
+        next = (parent + 2) % 4 + 1;
+    }
+
+    return distances;
+}
+
+/**
+ * Finds the reachable tile with the largest distance. Ties are settled by picking the first tile in memory order.
+ *
+ * @param distances The distance map, as given by computeDistanceField().
+ * @param coordArr Pointer to an array of at least 2 integers, where the coordinates of the tile are stored.
+ * @return The distance of the farthest tile.
+ */
+int findFarthestTile(const unsigned int* distances, int* coordArr) {
+    const long long tileCount = (long long) mazeWidth * mazeHeight;
+    unsigned int farthest = 0;
+
+    #pragma omp parallel for schedule(static) reduction(max:farthest)
+    for (long long i = 0; i < tileCount; i++) {
+        if (distances[i] != DISTANCE_UNREACHED && distances[i] > farthest) {
+            farthest = distances[i];
+        }
+    }
+
+    long long index = 0;
+    while (distances[index] != farthest) {
+        index++;
+    }
+
+    coordArr[0] = (int) (index / mazeHeight);
+    coordArr[1] = (int) (index % mazeHeight);
+    return (int) farthest;
+}
+
+/**
+ * Writes the distance map to a binary file, so it can be used for difficulty heatmaps.
+ *
+ * The file starts with the 4 bytes "CMZD", followed by the width and height as 32-bit unsigned integers.
+ * After the header, every distance follows as a 32-bit unsigned integer, row by row from the top left tile.
+ * All integers use the byte order of the machine that wrote the file.
+ *
+ * @param filepath The path of the file to write.
+ * @param distances The distance map, as given by computeDistanceField().
+ * @return 1 if the file was written, and 0 if not.
+ */
+int writeDistanceMap(const char* filepath, const unsigned int* distances) {
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    uint32_t header[2] = {(uint32_t) mazeWidth, (uint32_t) mazeHeight};
+    uint32_t* row = (uint32_t*) malloc(mazeWidth * sizeof(uint32_t));
+    int success = row != NULL
+            && fwrite("CMZD", 1, 4, file) == 4
+            && fwrite(header, sizeof(uint32_t), 2, file) == 2;
+
+    for (int y = 0; y < mazeHeight && success; y++) {
+        for (int x = 0; x < mazeWidth; x++) {
+            row[x] = distances[(size_t) x * mazeHeight + y];
+        }
+        success = fwrite(row, sizeof(uint32_t), mazeWidth, file) == (size_t) mazeWidth;
+    }
+
+    free(row);
+    return fclose(file) == 0 && success;
+}
@@ -0,0 +1,18 @@
+/**
+ * Header file for the distance field of the maze.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_DISTANCE_H
+#define MAZEGENERATOR_DISTANCE_H
+
+#define DISTANCE_UNREACHED 0xFFFFFFFFu
+
+unsigned int* computeDistanceField(int x, int y);
+int findFarthestTile(const unsigned int* distances, int* coordArr);
+int writeDistanceMap(const char* filepath, const unsigned int* distances);
+
+#endif
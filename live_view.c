@@ -0,0 +1,318 @@
+/**
+ * Draws the maze to a terminal while it is being generated.
+ *
+ * The whole maze is only drawn once. After that, every tile changed since the last frame is remembered,
+ * and only the characters belonging to those tiles are redrawn, using ANSI cursor positioning.
+ * Characters next to each other on a row are written as one run, and a frame is collected in memory
+ * so it reaches the stream in a single write.
+ *
+ * Frames are limited both by the frame rate cap, and by how much of the generation time drawing may take up.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "common.h"
+#include "maze_data.h"
+#include "output.h"
+#include "live_view.h"
+
+// The clock is only read every this many ticks, as reading it costs more than a carving step.
+#define TICKS_PER_CLOCK_CHECK 64
+// Drawing may take at most this share of the time since the live view started.
+#define DRAW_TIME_BUDGET 0.05
+// Once more tiles than this have changed between two frames, the whole maze is redrawn instead.
+#define DIRTY_LIST_CAPACITY 65536
+// The most characters passed to csprintf at once.
+#define GROUP_CAPACITY 256
+// Characters at most this far apart on a row share a run, as redrawing a few unchanged characters is cheaper
+// than moving the cursor.
+#define RUN_GAP_LIMIT 4
+// Each tile owns its own centre and the 4 walls around it.
+#define GLYPHS_PER_TILE 5
+
+#define PLAIN -1
+
+struct FrameBuffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+};
+
+static struct FrameBuffer frame;
+static unsigned char* dirtyFlags;
+static uint32_t* dirtyTiles;
+static uint64_t* glyphKeys;
+static size_t dirtyCount;
+static int fullRedraw;
+
+static unsigned int tickCount;
+static double frameInterval;
+static double startTime;
+static double lastFrameTime;
+static double drawTime;
+
+/**
+ * @return The current time in seconds.
+ */
+static double now() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Makes sure the frame buffer has room for the given amount of additional characters.
+ */
+static void reserve(size_t extra) {
+    if (frame.length + extra <= frame.capacity) {
+        return;
+    }
+
+    size_t capacity = frame.capacity ? frame.capacity : 4096;
+    while (capacity < frame.length + extra) {
+        capacity *= 2;
+    }
+    char* data = (char*) realloc(frame.data, capacity);
+    if (data == NULL) {
+        fprintf(stderr, "Live view ran out of memory\n");
+        exit(1);
+    }
+    frame.data = data;
+    frame.capacity = capacity;
+}
+
+static void appendString(const char* string) {
+    size_t length = strlen(string);
+    reserve(length);
+    memcpy(frame.data + frame.length, string, length);
+    frame.length += length;
+}
+
+/**
+ * Appends a group of characters sharing a colour, through csprintf if the group is coloured.
+ */
+static void appendGroup(const char* group, int colour) {
+    if (colour == PLAIN) {
+        appendString(group);
+        return;
+    }
+
+    reserve(strlen(group) + sizeof(ANSI_COLOR_MAGENTA) + sizeof(ANSI_COLOR_RESET) + 1);
+    frame.length += csprintf(frame.data + frame.length, (enum colours) colour, group);
+}
+
+/**
+ * Finds the character of the printed maze at the given position, laid out the same way as fPrintMaze.
+ *
+ * @param col The 0-indexed column of the character.
+ * @param row The 0-indexed row of the character.
+ * @param colour Pointer to where the colour of the character is stored, or PLAIN if it has none.
+ * @return The character to draw.
+ */
+static const char* glyphAt(int col, int row, int* colour) {
+    *colour = PLAIN;
+
+    // Corners between tiles never change.
+    if (col % 2 == 0 && row % 2 == 0) {
+        return WALL_SYMBOL;
+    }
+
+    int x = col / 2, y = row / 2;
+    if (col % 2 == 1 && row % 2 == 1) {
+        if (isStartTile(x, y)) {
+            *colour = GREEN;
+            return START_SYMBOL;
+        }
+        if (isEndTile(x, y)) {
+            *colour = RED;
+            return END_SYMBOL;
+        }
+        return FREE_SYMBOL;
+    }
+
+    int hasWall;
+    if (col % 2 == 1) {
+        hasWall = y < mazeHeight ? getWall(x, y, NORTH) : getWall(x, y - 1, SOUTH);
+    } else {
+        hasWall = x < mazeWidth ? getWall(x, y, WEST) : getWall(x - 1, y, EAST);
+    }
+    return hasWall ? WALL_SYMBOL : FREE_SYMBOL;
+}
+
+/**
+ * Appends a run of characters on one row, preceded by a single cursor movement.
+ * Characters sharing a colour are grouped, so each colour change costs one escape sequence.
+ */
+static void appendRun(int row, int col, int length) {
+    char cursor[32];
+    sprintf(cursor, "\x1b[%d;%dH", row + 1, col + 1);
+    appendString(cursor);
+
+    char group[GROUP_CAPACITY + 1];
+    size_t groupLength = 0;
+    int groupColour = PLAIN;
+
+    for (int i = 0; i < length; i++) {
+        int colour;
+        const char* glyph = glyphAt(col + i, row, &colour);
+        size_t glyphLength = strlen(glyph);
+
+        if (groupLength && (colour != groupColour || groupLength + glyphLength > GROUP_CAPACITY)) {
+            appendGroup(group, groupColour);
+            groupLength = 0;
+        }
+
+        groupColour = colour;
+        memcpy(group + groupLength, glyph, glyphLength);
+        groupLength += glyphLength;
+        group[groupLength] = '\0';
+    }
+
+    if (groupLength) {
+        appendGroup(group, groupColour);
+    }
+}
+
+static int compareKeys(const void* a, const void* b) {
+    uint64_t keyA = *(const uint64_t*) a, keyB = *(const uint64_t*) b;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/**
+ * Redraws every character belonging to a changed tile, and writes the frame to the output stream.
+ */
+static void drawFrame() {
+    frame.length = 0;
+
+    if (fullRedraw) {
+        for (int row = 0; row <= 2 * mazeHeight; row++) {
+            appendRun(row, 0, 2 * mazeWidth + 1);
+        }
+    } else if (dirtyCount) {
+        // Sorting the characters by row, then column, lines up the ones which can share a run.
+        size_t keyCount = 0;
+        for (size_t i = 0; i < dirtyCount; i++) {
+            uint64_t col = 2 * (dirtyTiles[i] / mazeHeight) + 1;
+            uint64_t row = 2 * (dirtyTiles[i] % mazeHeight) + 1;
+            glyphKeys[keyCount++] = row << 32 | col;
+            glyphKeys[keyCount++] = (row - 1) << 32 | col;
+            glyphKeys[keyCount++] = (row + 1) << 32 | col;
+            glyphKeys[keyCount++] = row << 32 | (col - 1);
+            glyphKeys[keyCount++] = row << 32 | (col + 1);
+        }
+        qsort(glyphKeys, keyCount, sizeof(uint64_t), compareKeys);
+
+        size_t runStart = 0;
+        for (size_t i = 1; i <= keyCount; i++) {
+            if (i < keyCount && glyphKeys[i] <= glyphKeys[i - 1] + RUN_GAP_LIMIT
+                    && glyphKeys[i] >> 32 == glyphKeys[runStart] >> 32) {
+                continue;
+            }
+
+            int row = (int) (glyphKeys[runStart] >> 32);
+            int col = (int) (glyphKeys[runStart] & 0xFFFFFFFFu);
+            appendRun(row, col, (int) (glyphKeys[i - 1] - glyphKeys[runStart]) + 1);
+            runStart = i;
+        }
+    }
+
+    for (size_t i = 0; i < dirtyCount; i++) {
+        dirtyFlags[dirtyTiles[i]] = 0;
+    }
+    dirtyCount = 0;
+    fullRedraw = 0;
+
+    FILE* stream = get_stream();
+    fwrite(frame.data, 1, frame.length, stream);
+    fflush(stream);
+}
+
+/**
+ * Clears the terminal and draws the whole maze. Must be called after mazeInit().
+ */
+void liveViewStart() {
+    size_t tileCount = (size_t) mazeWidth * mazeHeight;
+    dirtyFlags = (unsigned char*) calloc(tileCount, sizeof(unsigned char));
+    dirtyTiles = (uint32_t*) malloc(DIRTY_LIST_CAPACITY * sizeof(uint32_t));
+    glyphKeys = (uint64_t*) malloc(DIRTY_LIST_CAPACITY * GLYPHS_PER_TILE * sizeof(uint64_t));
+    if (dirtyFlags == NULL || dirtyTiles == NULL || glyphKeys == NULL) {
+        fprintf(stderr, "Live view ran out of memory\n");
+        exit(1);
+    }
+
+    frameInterval = 1.0 / live_view_fps;
+    startTime = lastFrameTime = now();
+    drawTime = 0;
+    tickCount = 0;
+
+    // Hide the cursor and clear the screen, then draw everything.
+    fprintf(get_stream(), "\x1b[?25l\x1b[2J");
+    fullRedraw = 1;
+    drawFrame();
+}
+
+/**
+ * Remembers that the tile at the given coordinates must be redrawn in the next frame.
+ *
+ * @param x The 0-indexed column of the tile.
+ * @param y The 0-indexed row of the tile.
+ */
+void liveViewMarkDirty(int x, int y) {
+    size_t tile = (size_t) x * mazeHeight + y;
+    if (dirtyFlags == NULL || fullRedraw || dirtyFlags[tile]) {
+        return;
+    }
+
+    if (dirtyCount == DIRTY_LIST_CAPACITY) {
+        fullRedraw = 1;
+        return;
+    }
+    dirtyFlags[tile] = 1;
+    dirtyTiles[dirtyCount++] = (uint32_t) tile;
+}
+
+/**
+ * Called once per generation step. Draws a frame if the frame rate cap and the drawing budget both allow it.
+ */
+void liveViewTick() {
+    if (++tickCount % TICKS_PER_CLOCK_CHECK || (dirtyCount == 0 && !fullRedraw)) {
+        return;
+    }
+
+    double frameStart = now();
+    if (frameStart - lastFrameTime < frameInterval || drawTime > DRAW_TIME_BUDGET * (frameStart - startTime)) {
+        return;
+    }
+
+    drawFrame();
+    lastFrameTime = now();
+    drawTime += lastFrameTime - frameStart;
+}
+
+/**
+ * Draws the remaining changes, and leaves the cursor below the maze.
+ */
+void liveViewStop() {
+    drawFrame();
+
+    FILE* stream = get_stream();
+    fprintf(stream, "\x1b[%d;1H\x1b[?25h", 2 * mazeHeight + 2);
+    fflush(stream);
+
+    free(dirtyFlags);
+    free(dirtyTiles);
+    free(glyphKeys);
+    free(frame.data);
+    dirtyFlags = NULL;
+    dirtyTiles = NULL;
+    glyphKeys = NULL;
+    frame.data = NULL;
+    frame.capacity = 0;
+}
@@ -0,0 +1,17 @@
+/**
+ * Header file for the live view of the maze generation.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_LIVE_VIEW_H
+#define MAZEGENERATOR_LIVE_VIEW_H
+
+void liveViewStart();
+void liveViewMarkDirty(int x, int y);
+void liveViewTick();
+void liveViewStop();
+
+#endif
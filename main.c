@@ -24,15 +24,41 @@
 #include <string.h>
 #include "common.h"
 #include "maze_API.h"
+#include "maze_data.h"
 #include "output.h"
+#include "analysis.h"
+#include "distance.h"
+#include "validate.h"
+#include "live_view.h"
+#include "trace.h"
+#include "topology.h"
+#include "path_index.h"
 
 int mazeWidth = 8;
 int mazeHeight = 8;
 int randomBranchLimit = 20;
 int use_colours = 0;
 int print_all_branches = 0;
+int analyze_maze = 0;
+int far_end_tile = 0;
+int validate_maze = 0;
+int live_view_fps = 0;
+int maze_topology = TOPOLOGY_GRID;
+int maze_layers = 1;
+unsigned char* maze_mask = NULL;
+int maze_engine = ENGINE_HUNT_AND_KILL;
+int benchmark = 0;
 
 unsigned int seed;
+int widthGiven = 0;
+int heightGiven = 0;
+int maskWidth = 0;
+int maskHeight = 0;
+char distanceMapPath[256];
+char pathIndexPath[256];
+char loadIndexPath[256];
+int* queryCoords = NULL;
+int queryCount = 0;
 
 #if LINUX_INCREASE_STACK_SIZE == 1
 #include <sys/resource.h>
@@ -66,6 +92,22 @@ void allocate_stack_size() {
  *  <li>[-o, --output]: Sets the stream or file to write the resulting maze to.</li>
  *  <li>[-bl, --branch-limit]: Sets the branch limit used for maze generation.</li>
  *  <li>[-c, -colour]: Enables coloured output.</li>
+ *  <li>[-pab, --print-all-branches]: Prints the maze after every branch iteration.</li>
+ *  <li>[-a, --analyze]: Outputs the difficulty metrics of the maze as JSON instead of the maze itself.</li>
+ *  <li>[-fe, --far-end]: Moves the end tile to the tile farthest from the start tile.</li>
+ *  <li>[-dm, --distance-map]: Writes the distance from the start tile to every tile into the given binary file.</li>
+ *  <li>[-v, --validate]: Checks that the generated maze is perfect, and exits with code 1 if it is not. Works for every topology.</li>
+ *  <li>[-lv, --live-view]: Draws the maze to a terminal while it is generated, at an optional frame rate cap (default 30).</li>
+ *  <li>[-t, --trace]: Records generation events, and writes them to the given file as a Chrome trace on exit.</li>
+ *  <li>[-tp, --topology]: Sets the shape of the cells, either "grid" or "hex". Hexagonal mazes are output as passage lists.</li>
+ *  <li>[-l, --layers]: Stacks the given number of grids on top of each other. Layered mazes are output as passage lists.</li>
+ *  <li>[-m, --mask]: Reads the tiles which are part of the maze from a text file, which also sets the width and height.
+ *      A width or height given alongside it must match the mask.</li>
+ *  <li>[-e, --engine]: Sets the generation engine, either "hunt" (hunt-and-kill, default) or "dfs" (recursive backtracker).</li>
+ *  <li>[-b, --benchmark]: Prints how long the maze took to generate, and to analyze if -a is given.</li>
+ *  <li>[-pi, --path-index]: Builds the path distance index of the maze, and saves it to the given file.</li>
+ *  <li>[-li, --load-index]: Maps a saved path distance index instead of generating a maze, to answer queries from.</li>
+ *  <li>[-q, --query]: Takes 4 values, x1 y1 x2 y2, and prints the distance and next step from the first tile to the second.</li>
  * </ul>
  *
  * @param argc An integer defining the item count of argv.
@@ -80,6 +122,7 @@ void readParameters(int argc, char* argv[]) {
             char readVal[10];
             sscanf(argv[++i], "%s", readVal);
             mazeWidth = strtol(readVal, NULL, 10);
+            widthGiven = 1;
 
             #if INCLUDE_MAX_SIZE == 1
             if (mazeWidth >= MAZE_MAX_SIZE) {
@@ -99,6 +142,7 @@ void readParameters(int argc, char* argv[]) {
             char readVal[10];
             sscanf(argv[++i], "%s", readVal);
             mazeHeight = strtol(readVal, NULL, 10);
+            heightGiven = 1;
 
             #if INCLUDE_MAX_SIZE
             if (mazeHeight >= MAZE_MAX_SIZE) {
@@ -175,9 +219,273 @@ void readParameters(int argc, char* argv[]) {
             printf("Printing all branch iterations\n");
             #endif
         }
+
+
+        // Outputs the maze metrics as JSON instead of the maze.
+        else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--analyze") == 0) {
+            analyze_maze = 1;
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Enabled maze analysis\n");
+            #endif
+        }
+
+
+        // Moves the end tile to the tile farthest from the start once the maze is generated.
+        else if (strcmp(argv[i], "-fe") == 0 || strcmp(argv[i], "--far-end") == 0) {
+            far_end_tile = 1;
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Placing the end tile farthest from the start\n");
+            #endif
+        }
+
+
+        // Writes the distance map of the maze to the specified filepath.
+        else if ((strcmp(argv[i], "-dm") == 0 || strcmp(argv[i], "--distance-map") == 0) && i+1 < argc) {
+            sscanf(argv[++i], "%255s", distanceMapPath);
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Writing distance map to %s\n", distanceMapPath);
+            #endif
+        }
+
+
+        // Checks that the generated maze is perfect.
+        else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--validate") == 0) {
+            validate_maze = 1;
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Enabled maze validation\n");
+            #endif
+        }
+
+
+        // Draws the maze while it is generated, redrawing only the changed tiles.
+        else if (strcmp(argv[i], "-lv") == 0 || strcmp(argv[i], "--live-view") == 0) {
+            live_view_fps = 30;
+            if (i+1 < argc && argv[i+1][0] >= '1' && argv[i+1][0] <= '9') {
+                live_view_fps = strtol(argv[++i], NULL, 10);
+            }
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Enabled live view at up to %d frames per second\n", live_view_fps);
+            #endif
+        }
+
+
+        // Records a trace of the program, written to the specified filepath on exit.
+        else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--trace") == 0) && i+1 < argc) {
+            char tracePath[256];
+            sscanf(argv[++i], "%255s", tracePath);
+
+            if (!traceStart(tracePath)) {
+                cfprintf(stderr, RED, "Error: ");
+                fprintf(stderr, "Could not enable tracing\n");
+            }
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Writing trace to %s\n", tracePath);
+            #endif
+        }
+
+
+        // Sets the shape of the maze cells.
+        else if ((strcmp(argv[i], "-tp") == 0 || strcmp(argv[i], "--topology") == 0) && i+1 < argc) {
+            i++;
+            if (strcmp(argv[i], "hex") == 0) maze_topology = TOPOLOGY_HEX;
+            else if (strcmp(argv[i], "grid") == 0) maze_topology = TOPOLOGY_GRID;
+            else {
+                cfprintf(stderr, RED, "Error: ");
+                fprintf(stderr, "Unknown topology %s, expected grid or hex\n", argv[i]);
+                exit(1);
+            }
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Set topology to %s\n", maze_topology == TOPOLOGY_HEX ? "hex" : "grid");
+            #endif
+        }
+
+
+        // Stacks several grids on top of each other.
+        else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--layers") == 0) && i+1 < argc) {
+            maze_layers = strtol(argv[++i], NULL, 10);
+            if (maze_layers < 1) {
+                cfprintf(stderr, RED, "Error: ");
+                fprintf(stderr, "The layer count must be at least 1, but was %s\n", argv[i]);
+                exit(1);
+            }
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Set layer count equal to %d\n", maze_layers);
+            #endif
+        }
+
+
+        // Reads which tiles are part of the maze from the specified filepath.
+        else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--mask") == 0) && i+1 < argc) {
+            free(maze_mask);
+            maze_mask = topologyLoadMask(argv[++i], &maskWidth, &maskHeight);
+            if (maze_mask == NULL) {
+                cfprintf(stderr, RED, "Error: ");
+                fprintf(stderr, "Could not read mask from %s\n", argv[i]);
+                exit(1);
+            }
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Read a %d by %d mask from %s\n", maskWidth, maskHeight, argv[i]);
+            #endif
+        }
+
+
+        // Sets the engine used to carve the maze.
+        else if ((strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--engine") == 0) && i+1 < argc) {
+            i++;
+            if (strcmp(argv[i], "dfs") == 0) maze_engine = ENGINE_BACKTRACKER;
+            else if (strcmp(argv[i], "hunt") == 0) maze_engine = ENGINE_HUNT_AND_KILL;
+            else {
+                cfprintf(stderr, RED, "Error: ");
+                fprintf(stderr, "Unknown engine %s, expected hunt or dfs\n", argv[i]);
+                exit(1);
+            }
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Set engine to %s\n", maze_engine == ENGINE_BACKTRACKER ? "recursive backtracker" : "hunt-and-kill");
+            #endif
+        }
+
+
+        // Saves the path distance index of the maze to the specified filepath.
+        else if ((strcmp(argv[i], "-pi") == 0 || strcmp(argv[i], "--path-index") == 0) && i+1 < argc) {
+            sscanf(argv[++i], "%255s", pathIndexPath);
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Saving path index to %s\n", pathIndexPath);
+            #endif
+        }
+
+
+        // Answers queries from a saved path distance index instead of generating a maze.
+        else if ((strcmp(argv[i], "-li") == 0 || strcmp(argv[i], "--load-index") == 0) && i+1 < argc) {
+            sscanf(argv[++i], "%255s", loadIndexPath);
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Loading path index from %s\n", loadIndexPath);
+            #endif
+        }
+
+
+        // Adds a distance query between two tiles.
+        else if ((strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--query") == 0) && i+4 < argc) {
+            int* coords = (int*) realloc(queryCoords, (queryCount + 1) * 4 * sizeof(int));
+            if (coords == NULL) {
+                cfprintf(stderr, RED, "Error: ");
+                fprintf(stderr, "Not enough memory for the queries\n");
+                exit(1);
+            }
+            queryCoords = coords;
+            for (int j = 0; j < 4; j++) {
+                queryCoords[queryCount * 4 + j] = strtol(argv[++i], NULL, 10);
+            }
+            queryCount++;
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Added query from (%d, %d) to (%d, %d)\n", queryCoords[queryCount * 4 - 4],
+                   queryCoords[queryCount * 4 - 3], queryCoords[queryCount * 4 - 2], queryCoords[queryCount * 4 - 1]);
+            #endif
+        }
+
+
+        // Prints the generation time.
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = 1;
+
+            #if PRINT_PARAMETER_SETUP
+            cfprintf(stdout, GREEN, "Setup: ");
+            printf("Enabled benchmark\n");
+            #endif
+        }
     }
 }
 
+/**
+ * Checks that both tiles of a query are inside the maze the index was built over.
+ */
+static int queryInside(const struct PathIndex* index, const int* coords) {
+    for (int i = 0; i < 4; i += 2) {
+        if (coords[i] < 0 || coords[i] >= index->width || coords[i + 1] < 0 || coords[i + 1] >= index->height) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Answers every query given on the command line, through a single batch per query type.
+ * Queries with a tile outside the maze are reported as invalid, and left out of the batches.
+ *
+ * @param index The path distance index to answer from.
+ * @return 0 if every query could be answered, and 1 if not.
+ */
+int answerQueries(const struct PathIndex* index) {
+    int* from = (int*) calloc(queryCount * 4, sizeof(int));
+    if (from == NULL) {
+        cfprintf(stderr, RED, "Error: ");
+        fprintf(stderr, "Not enough memory for the queries\n");
+        return 1;
+    }
+    int* to = from + queryCount;
+    int* distances = to + queryCount;
+    int* steps = distances + queryCount;
+
+    int exitCode = 0;
+    int validCount = 0;
+    for (int i = 0; i < queryCount; i++) {
+        const int* coords = queryCoords + i * 4;
+        if (!queryInside(index, coords)) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Query (%d, %d) to (%d, %d) is invalid, as the maze is %d by %d tiles\n",
+                    coords[0], coords[1], coords[2], coords[3], index->width, index->height);
+            exitCode = 1;
+            continue;
+        }
+
+        from[validCount] = coords[0] * index->height + coords[1];
+        to[validCount++] = coords[2] * index->height + coords[3];
+    }
+
+    pathIndexDistanceBatch(index, from, to, distances, validCount);
+    pathIndexNextStepBatch(index, from, to, steps, validCount);
+
+    for (int i = 0; i < validCount; i++) {
+        cfprintf(stdout, GREEN, "Query: ");
+        printf("(%d, %d) to (%d, %d): ", from[i] / index->height, from[i] % index->height,
+               to[i] / index->height, to[i] % index->height);
+        if (distances[i] < 0) {
+            printf("unreachable\n");
+        } else {
+            printf("distance %d, next step (%d, %d)\n", distances[i],
+                   steps[i] / index->height, steps[i] % index->height);
+        }
+    }
+
+    free(from);
+    return exitCode;
+}
+
 /**
  * Program main entry point.
  *
@@ -186,10 +494,6 @@ void readParameters(int argc, char* argv[]) {
  * @return Exit code of the program.
  */
 int main(int argc, char* argv[]) {
-#if DEBUG_LEVEL >= 1
-    setvbuf(stdout, NULL, _IONBF, 0);
-#endif
-
 #if LINUX_INCREASE_STACK_SIZE == 1
     allocate_stack_size();
 #endif
@@ -198,10 +502,181 @@ int main(int argc, char* argv[]) {
     seed = time(0);
     readParameters(argc, argv);
 
+    // The mask sets the size of the maze, and is indexed by it, so the two must agree no matter the argument order.
+    if (maze_mask != NULL) {
+        if ((widthGiven && mazeWidth != maskWidth) || (heightGiven && mazeHeight != maskHeight)) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "The mask is %d by %d tiles, but the maze was set to %d by %d\n",
+                    maskWidth, maskHeight, mazeWidth, mazeHeight);
+            return 1;
+        }
+        mazeWidth = maskWidth;
+        mazeHeight = maskHeight;
+    }
+
+    // Only grids can be stacked, which is decided once every argument is read so the order doesn't matter.
+    if (maze_layers > 1) {
+        if (maze_topology == TOPOLOGY_HEX) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Hexagonal mazes can't be layered\n");
+            return 1;
+        }
+        maze_topology = TOPOLOGY_LAYERED;
+    }
+
+    if (loadIndexPath[0]) {
+        struct PathIndex* index = pathIndexMap(loadIndexPath);
+        if (index == NULL) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Could not map path index from %s\n", loadIndexPath);
+            return 1;
+        }
+
+        int exitCode = answerQueries(index);
+        pathIndexFree(index);
+        return exitCode;
+    }
+
+    // Only grids have a wall state, which everything but the generator itself works from.
+    if (maze_topology != TOPOLOGY_GRID && (analyze_maze || far_end_tile
+            || distanceMapPath[0] || live_view_fps || print_all_branches || pathIndexPath[0] || queryCount)) {
+        cfprintf(stderr, RED, "Error: ");
+        fprintf(stderr, "Hexagonal and layered mazes can only be generated and printed\n");
+        return 1;
+    }
+    if (maze_mask != NULL && (maze_topology != TOPOLOGY_GRID || maze_layers > 1)) {
+        cfprintf(stderr, RED, "Error: ");
+        fprintf(stderr, "Masks can only be applied to single layer grids\n");
+        return 1;
+    }
+
     srand(seed);
+    TRACE_PHASE_BEGIN("init");
     mazeInit();
+    TRACE_PHASE_END("init");
+
+    if (live_view_fps) {
+        liveViewStart();
+    }
+
+    TRACE_PHASE_BEGIN("generate");
+    struct timespec generateStart, generateEnd;
+    timespec_get(&generateStart, TIME_UTC);
     populateMaze();
-    fPrintMaze();
+    timespec_get(&generateEnd, TIME_UTC);
+    TRACE_PHASE_END("generate");
+
+    const double generateMilliseconds = (generateEnd.tv_sec - generateStart.tv_sec) * 1e3
+                                      + (generateEnd.tv_nsec - generateStart.tv_nsec) / 1e6;
+    if (benchmark) {
+        cfprintf(stdout, CYAN, "Benchmark: ");
+        printf("Generated %d by %d maze in %.3f ms\n", mazeWidth, mazeHeight, generateMilliseconds);
+    }
+
+    if (far_end_tile || distanceMapPath[0]) {
+        TRACE_PHASE_BEGIN("distance");
+        int coords[2];
+        getStartTile(coords);
+        unsigned int* distances = computeDistanceField(coords[0], coords[1]);
+        if (distances == NULL) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Not enough memory for the distance map\n");
+            return 1;
+        }
+
+        if (far_end_tile) {
+            findFarthestTile(distances, coords);
+            setEndTile(coords[0], coords[1]);
+        }
+        if (distanceMapPath[0] && !writeDistanceMap(distanceMapPath, distances)) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Could not write distance map to %s\n", distanceMapPath);
+        }
+        free(distances);
+        TRACE_PHASE_END("distance");
+    }
+
+    if (live_view_fps) {
+        liveViewStop();
+    }
+
+    int exitCode = 0;
+    if (pathIndexPath[0] || queryCount) {
+        TRACE_PHASE_BEGIN("path index");
+        struct PathIndex* index = pathIndexBuild();
+        if (index == NULL) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Not enough memory for the path index\n");
+            return 1;
+        }
+
+        if (pathIndexPath[0] && !pathIndexSave(index, pathIndexPath)) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Could not write path index to %s\n", pathIndexPath);
+            exitCode = 1;
+        }
+        if (queryCount && answerQueries(index)) {
+            exitCode = 1;
+        }
+        pathIndexFree(index);
+        TRACE_PHASE_END("path index");
+    }
+
+    if (validate_maze) {
+        TRACE_PHASE_BEGIN("validate");
+        struct MazeValidation validation;
+        int isPerfect;
+        if (maze_topology == TOPOLOGY_GRID && maze_mask == NULL) {
+            isPerfect = validateMaze(&validation);
+        } else {
+            // Only the topology knows which cells are part of the maze, and hexagonal and layered mazes have no walls.
+            int cells[2];
+            getStartEndCells(cells);
+            isPerfect = validateTopology(getTopology(), cells[0], cells[1], &validation);
+        }
+        if (isPerfect < 0) {
+            cfprintf(stderr, RED, "Error: ");
+            fprintf(stderr, "Not enough memory to validate the maze\n");
+            return 1;
+        } else if (isPerfect) {
+            cfprintf(stdout, GREEN, "Validate: ");
+            printf("Maze is perfect\n");
+        } else {
+            exitCode = 1;
+            cfprintf(stdout, RED, "Validate: ");
+            printf("Maze is not perfect: %lld passages, %lld components, %lld cycles, "
+                   "%lld mismatched walls, %lld open outer walls, markers %s\n",
+                   validation.passages, validation.components, validation.cycles,
+                   validation.mismatchedWalls, validation.openOuterWalls,
+                   validation.markersValid ? "valid" : "invalid");
+        }
+        TRACE_PHASE_END("validate");
+    }
+
+    if (analyze_maze) {
+        TRACE_PHASE_BEGIN("analyze");
+        struct MazeAnalysis analysis;
+        struct timespec analyzeStart, analyzeEnd;
+        timespec_get(&analyzeStart, TIME_UTC);
+        analyzeMaze(&analysis);
+        timespec_get(&analyzeEnd, TIME_UTC);
+
+        // The analysis is meant to cost at most a tenth of the generation, so both are shown side by side.
+        if (benchmark) {
+            double milliseconds = (analyzeEnd.tv_sec - analyzeStart.tv_sec) * 1e3
+                                + (analyzeEnd.tv_nsec - analyzeStart.tv_nsec) / 1e6;
+            cfprintf(stdout, CYAN, "Benchmark: ");
+            printf("Analyzed the maze in %.3f ms, %.1f%% of the generation time\n", milliseconds,
+                   generateMilliseconds > 0 ? milliseconds * 100 / generateMilliseconds : 0.0);
+        }
+        fPrintAnalysis(&analysis);
+        TRACE_PHASE_END("analyze");
+    } else if (!live_view_fps) {
+        TRACE_PHASE_BEGIN("print");
+        if (maze_topology == TOPOLOGY_GRID) fPrintMaze();
+        else fPrintPassages();
+        TRACE_PHASE_END("print");
+    }
 
-    return 0;
+    return exitCode;
 }
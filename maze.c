@@ -2,139 +2,382 @@
  * This file utilizes a lot of bit-masking. I used the resource below to learn shorthands for extracting each bit value.
  * https://www.learn-c.org/en/Bitmasks
  *
+ * The maze is carved over a topology (see topology.h), so the same generator works for grids, masked grids,
+ * hexagonal grids and layered grids. When the topology is a grid, every carved passage is mirrored into the
+ * wall state of maze_data.c, which is what the output, analysis and validation work from.
+ *
  * TODO:
  * - Could start random branch from a random point, visited or not. If unvisited, make sure it ends on the path.
- * - WIP: Could precalculate the eligibility for branching, reducing repeated calculations.
  *
  * @author Datskalf
- * @version 1.1
- * @date 2023-10-30
+ * @version 1.2
+ * @date 2026-10-19
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
 #include "common.h"
 #include "maze.h"
 #include "maze_data.h"
 #include "maze_API.h"
 #include "rng.h"
 #include "output.h"
+#include "live_view.h"
+#include "trace.h"
+#include "topology.h"
+
+static struct Topology* topology;
+static int startCell;
+static int endCell;
+static int earliestBranchCell;
 
 /**
- * Creates a blank maze with all walls filled in.
+ * A stack of small integers, packed as tightly as the largest of them allows.
+ * Each entry is the neighbour index leading back to the previous cell, so a grid only needs 2 bits per entry.
+ */
+struct PackedStack {
+    uint64_t* words;
+    size_t wordCount;
+    size_t size;
+    int bitsPerEntry;
+    int entriesPerWord;
+};
+
+/**
+ * @return The 0-indexed column of the cell, within its layer.
+ */
+static int cellColumn(int cell) {
+    return (cell % (topology->width * topology->height)) / topology->height;
+}
+
+/**
+ * Creates a blank maze with all walls filled in, over the topology selected by maze_topology.
  * Once the blank is created, path generation is run.
  */
 void populateMaze() {
+    switch (maze_topology) {
+        case TOPOLOGY_HEX:
+            topology = topologyCreateHex(mazeWidth, mazeHeight);
+            break;
+        case TOPOLOGY_LAYERED:
+            topology = topologyCreateLayered(mazeWidth, mazeHeight, maze_layers);
+            break;
+        default:
+            topology = topologyCreateGrid(mazeWidth, mazeHeight, maze_mask);
+            break;
+    }
 
+    if (topology == NULL) {
+        fprintf(stderr, "The maze has more than %d cells, or there is not enough memory for its topology\n", INT_MAX);
+        exit(1);
+    }
+
+    // The start and end are placed in the first and last open tiles, so they must share a region.
+    if (maze_mask != NULL) {
+        int regions = topologyCountRegions(topology);
+        if (regions < 0) {
+            fprintf(stderr, "Not enough memory to check the mask\n");
+            exit(1);
+        } else if (regions != 1) {
+            fprintf(stderr, "The mask must have exactly one open region, but it has %d\n", regions);
+            exit(1);
+        }
+    }
 
     generatePaths();
+
+    // Every passage of a plain grid is mirrored in its walls, so the topology is only kept when something needs it.
+    // Masked grids keep it for validation, as only the topology knows which tiles are part of the maze.
+    if (topology->kind == TOPOLOGY_GRID && maze_mask == NULL) {
+        topologyFree(topology);
+        topology = NULL;
+    }
+}
+
+/**
+ * @return The topology the maze was generated over, or NULL for plain grids, which only keep their wall state.
+ */
+const struct Topology* getTopology() {
+    return topology;
+}
+
+/**
+ * Stores the cells holding the start and end of the maze in the passed array.
+ *
+ * @param cellArr Pointer to an array of at least 2 integers.
+ */
+void getStartEndCells(int* cellArr) {
+    cellArr[0] = startCell;
+    cellArr[1] = endCell;
 }
 
 /**
- * Starting from the given coordinates, creates a random path until the head
- * cannot go anywhere, or hits the end tile.
+ * Carves the passage in the given slot, and mirrors it into the walls of both tiles if the maze is a grid.
  *
- * @param x The 0-indexed column of the tile.
- * @param y The 0-indexed row of the tile.
+ * @param cell The cell the passage starts in.
+ * @param slot The topology slot of the passage.
+ * @return The cell the passage leads to.
  */
-void createPathSegment(int x, int y) {
-    int validPaths;
-
-    // Continue until the head doesn't have an unvisited tile next to it or the head is on the end.
-    while ((validPaths = getUnvisitedNeighbors(x, y))) {
-
-        // Sum up how many legal paths there are
-        int pathOptions = ((validPaths >> NORTH) & 1)
-                        + ((validPaths >> EAST)  & 1)
-                        + ((validPaths >> SOUTH) & 1)
-                        + ((validPaths >> WEST)  & 1);
-
-        // Create an array to hold each possible movement, then select one at random
-        int paths[pathOptions];
-        for (int i = 0, n = 0; i < 4; i++) {
-            if ((validPaths >> i)&1) {
-                paths[n++] = i;
+static int carvePassage(int cell, size_t slot) {
+    int next = topologyCarve(topology, cell, slot);
+
+    if (topology->kind == TOPOLOGY_GRID) {
+        int x = cell / mazeHeight, y = cell % mazeHeight;
+        int nextX = next / mazeHeight, nextY = next % mazeHeight;
+        enum Direction direction = (enum Direction) topologyLabel(topology, slot);
+        setTileWall(x, y, direction, OFF);
+        setTileWall(nextX, nextY, (enum Direction) ((direction + 2) % 4), OFF);
+    }
+
+    return next;
+}
+
+/**
+ * Starting from the given cell, creates a random path until the head
+ * cannot go anywhere, or hits the end cell.
+ *
+ * @param cell The index of the cell, as laid out in topology.h.
+ */
+void createPathSegment(int cell) {
+    int paths[topology->maxDegree];
+    int neighbors[topology->maxDegree];
+    TRACE_BEGIN("segment", cellColumn(cell), cell % topology->height);
+
+    // Continue until the head doesn't have an unvisited cell next to it or the head is on the end.
+    while (1) {
+
+        // Collect each possible movement, then select one at random.
+        // A cell is unvisited as long as no passage has been carved into it.
+        int pathOptions = 0;
+        const size_t firstSlot = topologyFirstSlot(topology, cell);
+        const int slotCount = topologyNeighborsOf(topology, cell, neighbors);
+        for (int i = 0; i < slotCount; i++) {
+            if (neighbors[i] != TOPOLOGY_NO_NEIGHBOR && topology->degree[neighbors[i]] == 0) {
+                paths[pathOptions++] = i;
             }
         }
-        int randDir = paths[randInt(pathOptions)];
-
-        // Set the wall states for the current and next tile
-        switch (randDir) {
-            case 0:
-                setTileWall(x, y--, NORTH, OFF);
-                setTileWall(x, y, SOUTH, OFF);
-                break;
-            case 1:
-                setTileWall(x++, y, EAST, OFF);
-                setTileWall(x, y, WEST, OFF);
-                break;
-            case 2:
-                setTileWall(x, y++, SOUTH, OFF);
-                setTileWall(x, y, NORTH, OFF);
-                break;
-            case 3:
-                setTileWall(x--, y, WEST, OFF);
-                setTileWall(x, y, EAST, OFF);
-                break;
-            default:
-                break;
+        if (pathOptions == 0) {
+            break;
         }
 
-        unsigned char unvisitedNeighbors = getUnvisitedNeighbors(x, y);
-        int count = (
-                (unvisitedNeighbors >> NORTH) & 1
-                + (unvisitedNeighbors >> EAST) & 1
-                + (unvisitedNeighbors >> SOUTH) & 1
-                + (unvisitedNeighbors >> WEST) & 1
-                );
-        if (count == 2 || count == 3) {
-            
+        cell = carvePassage(cell, firstSlot + paths[randInt(pathOptions)]);
+
+        if (live_view_fps) {
+            liveViewTick();
         }
 
-        // If head is on the end tile, exit
-        if (isEndTile(x, y)) {
+        // If head is on the end cell, exit
+        if (cell == endCell) {
+            TRACE_END("segment");
             return;
         }
     }
 
-    if (print_all_branches >= 1)
+    TRACE_END("segment");
+
+    // The live view already shows every change, so there is no need to print the whole maze as well.
+    if (print_all_branches >= 1 && !live_view_fps && topology->kind == TOPOLOGY_GRID)
         fPrintMaze();
 }
 
 /**
- * Initially, creates a path from the start tile.
+ * Checks whether the cell has a neighbour no passage has been carved into yet.
+ */
+static int hasUnvisitedNeighbor(int cell) {
+    int neighbors[topology->maxDegree];
+    const int slotCount = topologyNeighborsOf(topology, cell, neighbors);
+    for (int i = 0; i < slotCount; i++) {
+        if (neighbors[i] != TOPOLOGY_NO_NEIGHBOR && topology->degree[neighbors[i]] == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Collects cells which already have a passage, and still have an unvisited neighbour.
+ * How many passages a cell can take depends on the topology, so cells which have neighbours left are
+ * checked no matter how many passages they already have.
+ * The search stops once randomBranchLimit cells are found. The next search continues from the first cell which
+ * was either collected or still unvisited, as an unvisited cell can become a branch point once a path reaches it.
+ * The function will then pick one at random, store it in the passed pointer, and return success or failure.
+ *
+ * @param cellPtr Pointer to where the selected branch point is stored.
+ * @return A boolean value stating whether a valid branch point was found or not.
+ */
+static int getRandomBranchPoint(int* cellPtr) {
+    int candidates[randomBranchLimit > 0 ? randomBranchLimit : 1];
+    int count = 0;
+    int keepLocating = 1;
+    int foundUnfinished = 0;
+
+    for (int cell = earliestBranchCell; cell < topology->cellCount && keepLocating; cell++) {
+        // Visited cells without unvisited neighbours are done for good, as cells are never unvisited again.
+        int unvisited = topology->degree[cell] == 0 && topologyNeighborCount(topology, cell) > 0;
+        int branchable = topology->degree[cell] >= 1 && hasUnvisitedNeighbor(cell);
+
+        if ((unvisited || branchable) && !foundUnfinished) {
+            earliestBranchCell = cell;
+            foundUnfinished = 1;
+        }
+        if (branchable) {
+            candidates[count++] = cell;
+        }
+
+        keepLocating = (count < randomBranchLimit);
+    }
+
+    // If there are any valid new branch points, pick a random one, and store it in the passed pointer.
+    if (count) {
+        *cellPtr = candidates[randInt(count)];
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Pushes an entry onto the stack, growing it if needed.
+ */
+static void stackPush(struct PackedStack* stack, unsigned int entry) {
+    size_t word = stack->size / stack->entriesPerWord;
+    int shift = (int) (stack->size % stack->entriesPerWord) * stack->bitsPerEntry;
+
+    if (word == stack->wordCount) {
+        size_t wordCount = stack->wordCount ? stack->wordCount * 2 : 1024;
+        uint64_t* words = (uint64_t*) realloc(stack->words, wordCount * sizeof(uint64_t));
+        if (words == NULL) {
+            fprintf(stderr, "Not enough memory for the backtracker stack\n");
+            exit(1);
+        }
+        stack->words = words;
+        stack->wordCount = wordCount;
+    }
+
+    if (shift == 0) {
+        stack->words[word] = 0;
+    }
+    stack->words[word] |= (uint64_t) entry << shift;
+    stack->size++;
+}
+
+/**
+ * Pops the top entry off the stack. The stack must not be empty.
+ */
+static unsigned int stackPop(struct PackedStack* stack) {
+    stack->size--;
+    size_t word = stack->size / stack->entriesPerWord;
+    int shift = (int) (stack->size % stack->entriesPerWord) * stack->bitsPerEntry;
+
+    unsigned int entry = (unsigned int) (stack->words[word] >> shift) & ((1u << stack->bitsPerEntry) - 1);
+    stack->words[word] &= ~((((uint64_t) 1 << stack->bitsPerEntry) - 1) << shift);
+    return entry;
+}
+
+/**
+ * Carves the whole maze as a recursive backtracker, without recursing.
+ * The head keeps moving to a random unvisited neighbour, and backs up one cell at a time once it is stuck.
+ * Only the way back is remembered for each step, so the stack takes up 2 bits per cell on a grid.
+ *
+ * Every cell is entered once, and looked at once more for each passage leading out of it,
+ * so the total work is linear in the size of the maze.
+ */
+static void generateBacktracker() {
+    int paths[topology->maxDegree];
+    int neighbors[topology->maxDegree];
+    struct PackedStack stack = {NULL, 0, 0, 1, 64};
+    while ((1 << stack.bitsPerEntry) < topology->maxDegree) {
+        stack.bitsPerEntry++;
+    }
+    stack.entriesPerWord = 64 / stack.bitsPerEntry;
+
+    int cell = startCell;
+    int carving = 0;
+    while (1) {
+        int pathOptions = 0;
+        const size_t firstSlot = topologyFirstSlot(topology, cell);
+        const int slotCount = topologyNeighborsOf(topology, cell, neighbors);
+        for (int i = 0; i < slotCount; i++) {
+            if (neighbors[i] != TOPOLOGY_NO_NEIGHBOR && topology->degree[neighbors[i]] == 0) {
+                paths[pathOptions++] = i;
+            }
+        }
+
+        if (pathOptions) {
+            if (!carving) {
+                TRACE_BEGIN("segment", cellColumn(cell), cell % topology->height);
+                carving = 1;
+            }
+
+            int next = carvePassage(cell, firstSlot + paths[randInt(pathOptions)]);
+            stackPush(&stack, (unsigned int) (topologyFindSlot(topology, next, cell) - topologyFirstSlot(topology, next)));
+            cell = next;
+
+            // The stack holds one entry per step away from the start, so it is as deep as the solution is long.
+            if (cell == endCell && topology->kind == TOPOLOGY_GRID) {
+                setSolutionLength((long long) stack.size);
+            }
+
+            if (live_view_fps) {
+                liveViewTick();
+            }
+            continue;
+        }
+
+        if (carving) {
+            TRACE_END("segment");
+            carving = 0;
+
+            if (print_all_branches >= 1 && !live_view_fps && topology->kind == TOPOLOGY_GRID)
+                fPrintMaze();
+        }
+
+        if (stack.size == 0) {
+            break;
+        }
+        cell = topologyNeighbor(topology, topologyFirstSlot(topology, cell) + stackPop(&stack));
+    }
+
+    free(stack.words);
+}
+
+/**
+ * Initially, creates a path from the start cell.
  * After this path, will create branches for as long as there exists valid branch points.
+ * If the backtracker engine is selected, the whole maze is carved by it instead.
  *
- * A path is deemed finished once it either hits a dead end or the end tile.
+ * The start is the first cell which is part of the maze, and the end is the last one.
+ * A path is deemed finished once it either hits a dead end or the end cell.
  */
 void generatePaths() {
-    int startX = 0, startY = 0;
-    int endX = mazeWidth-1, endY = mazeHeight-1;
+    startCell = 0;
+    while (startCell + 1 < topology->cellCount && topologyNeighborCount(topology, startCell) == 0) {
+        startCell++;
+    }
+    endCell = topology->cellCount - 1;
+    while (endCell > startCell && topologyNeighborCount(topology, endCell) == 0) {
+        endCell--;
+    }
+    earliestBranchCell = 0;
 
     // Define the start and end tile locations
-    setStartTile(startX, startY);
-    setEndTile(endX, endY);
+    if (topology->kind == TOPOLOGY_GRID) {
+        setStartTile(startCell / mazeHeight, startCell % mazeHeight);
+        setEndTile(endCell / mazeHeight, endCell % mazeHeight);
+    }
 
+    if (maze_engine == ENGINE_BACKTRACKER) {
+        generateBacktracker();
+        return;
+    }
 
-#if PRINT_BRANCHES >= 1
-    static int iterationCount = 0;
-    printf("Branch iteration no %d", iterationCount++);
-    #if PRINT_BRANCHES >= 2
-        printf(": x=%d, y=%d", startX, startY);
-    #endif
-    printf("\n");
-#endif
-    createPathSegment(startX, startY);
+    createPathSegment(startCell);
 
     // loop for as long as there are valid branch points
-    int randTileCoord[2];
-    while (getRandomBranchPoint(randTileCoord)) {
-#if PRINT_BRANCHES >= 1
-        printf("Branch iteration no %d", iterationCount++);
-        #if PRINT_BRANCHES >= 2
-            printf(": x=%d, y=%d", randTileCoord[0], randTileCoord[1]);
-        #endif
-        printf("\n");
-#endif
-        createPathSegment(randTileCoord[0], randTileCoord[1]);
-    }
-}
\ No newline at end of file
+    int branchCell;
+    while (getRandomBranchPoint(&branchCell)) {
+        TRACE_INSTANT("branch", cellColumn(branchCell), branchCell % topology->height);
+        createPathSegment(branchCell);
+    }
+}
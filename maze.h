@@ -10,7 +10,7 @@
 
 //void setTileWall(int x, int y, enum Direction direction, enum State state);
 //void setAllTileWalls(int x, int y, enum State hasNorth, enum State hasEast, enum State hasSouth, enum State hasWest);
-void createPathSegment(int x, int y);
+void createPathSegment(int cell);
 void generatePaths();
 //int getUnvisitedNeighbors(int x, int y);
 //int getWalls(int x, int y);
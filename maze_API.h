@@ -7,9 +7,17 @@
 #ifndef MAZEGENERATOR_MAZE_API_H
 #define MAZEGENERATOR_MAZE_API_H
 
+enum Engine {
+    ENGINE_HUNT_AND_KILL = 0,
+    ENGINE_BACKTRACKER = 1
+};
+
 struct Tile;
+struct Topology;
 void mazeInit();
 void populateMaze();
 void printMaze();
+const struct Topology* getTopology();
+void getStartEndCells(int* cellArr);
 
 #endif
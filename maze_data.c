@@ -11,20 +11,31 @@
 #include "common.h"
 #include "maze_API.h"
 #include "maze_data.h"
+#include "live_view.h"
 #include "rng.h"
 
+#define WALK_NEXT_SHIFT 2
+#define WALK_NEXT_MASK (7 << WALK_NEXT_SHIFT)
+#define WALK_VISITED 32
+
 unsigned char* startTile;
 unsigned char* endTile;
 unsigned char** mazeState;
+unsigned char* mazeCells;
+
+// The number of steps from the start tile to the end tile, or -1 if it hasn't been measured since either tile moved.
+static long long knownSolutionLength = -1;
 
 /**
  * Assigns the required memory for the maze state array.
+ * All columns share one contiguous block, so whole-grid passes can walk the cells linearly.
  */
 void mazeInit() {
     mazeState = (unsigned char**) malloc(mazeWidth * sizeof(unsigned char*));
+    mazeCells = (unsigned char*) malloc((size_t) mazeWidth * mazeHeight * sizeof(unsigned char));
 
     for (int i = 0; i < mazeWidth; i++) {
-        mazeState[i] = (unsigned char*) malloc(mazeHeight * sizeof(unsigned char));
+        mazeState[i] = mazeCells + (size_t) i * mazeHeight;
     }
 
     for (int x = 0; x < mazeWidth; x++) {
@@ -50,6 +61,10 @@ void setTileWall(int x, int y, enum Direction direction, enum State state) {
 
     mazeState[x][y] &= ~(1 << direction); // Clear the wall state
     mazeState[x][y] |= stateNorm << direction; // Set the wall state equal to the parameter
+
+    if (live_view_fps) {
+        liveViewMarkDirty(x, y);
+    }
 }
 
 /**
@@ -70,11 +85,129 @@ void setAllTileWalls(int x, int y, enum State hasNorth, enum State hasEast, enum
 }
 
 void setStartTile(int x, int y) {
+    if (live_view_fps) {
+        int coords[2];
+        if (startTile != NULL) {
+            getStartTile(coords);
+            liveViewMarkDirty(coords[0], coords[1]);
+        }
+        liveViewMarkDirty(x, y);
+    }
+
     startTile = &mazeState[x][y];
+    knownSolutionLength = -1;
 }
 
 void setEndTile(int x, int y) {
+    if (live_view_fps) {
+        int coords[2];
+        if (endTile != NULL) {
+            getEndTile(coords);
+            liveViewMarkDirty(coords[0], coords[1]);
+        }
+        liveViewMarkDirty(x, y);
+    }
+
     endTile = &mazeState[x][y];
+    knownSolutionLength = -1;
+}
+
+/**
+ * Remembers how many steps the solution takes, for whoever measured it while carving.
+ * Moving the start or end tile afterwards forgets it again.
+ *
+ * @param length The number of steps from the start tile to the end tile.
+ */
+void setSolutionLength(long long length) {
+    knownSolutionLength = length;
+}
+
+/**
+ * @return The number of steps from the start tile to the end tile, or -1 if it isn't known.
+ */
+long long getSolutionLength() {
+    return knownSolutionLength;
+}
+
+/**
+ * Stores the coordinates of the start tile in the passed array.
+ *
+ * @param coordArr Pointer to an array of at least 2 integers.
+ */
+void getStartTile(int* coordArr) {
+    size_t index = startTile - mazeCells;
+    coordArr[0] = (int) (index / mazeHeight);
+    coordArr[1] = (int) (index % mazeHeight);
+}
+
+/**
+ * Stores the coordinates of the end tile in the passed array.
+ *
+ * @param coordArr Pointer to an array of at least 2 integers.
+ */
+void getEndTile(int* coordArr) {
+    size_t index = endTile - mazeCells;
+    coordArr[0] = (int) (index / mazeHeight);
+    coordArr[1] = (int) (index % mazeHeight);
+}
+
+/**
+ * Gives read-only access to the whole maze state.
+ * Tiles are stored column by column, so the tile at (x, y) is found at index x * mazeHeight + y,
+ * and the lower 4 bits of each tile hold the wall states indexed by enum Direction.
+ *
+ * @return Pointer to the first tile of the maze.
+ */
+const unsigned char* getMazeCells() {
+    return mazeCells;
+}
+
+/**
+ * Walks the maze depth first from the given tile, calling the visitor on every tile the first time it is reached.
+ * The walk keeps its state in one byte per tile instead of a stack, by remembering which direction leads back
+ * to the parent tile, and which direction should be tried next.
+ *
+ * @param root The index of the tile to start from, as laid out by getMazeCells().
+ * @param walk Pointer to one zeroed byte per tile. Once the walk is done, the bits in WALK_PARENT_MASK
+ *             of each reached tile hold the direction leading back to its parent.
+ * @param visit Called with each reached tile and its depth. The walk stops once it returns non-zero.
+ * @param context Passed on to every call of visit.
+ * @return The depth of the tile the walk was stopped at, or -1 if the visitor never stopped it.
+ */
+long long walkMaze(size_t root, unsigned char* walk, WalkVisitor visit, void* context) {
+    const long long offsets[4] = {-1, mazeHeight, 1, -(long long) mazeHeight};
+    size_t current = root;
+    long long depth = 0;
+
+    walk[current] = WALK_VISITED; // The root has no parent, so its parent direction is never used.
+    if (visit(context, current, depth)) {
+        return depth;
+    }
+
+    while (1) {
+        int next = (walk[current] & WALK_NEXT_MASK) >> WALK_NEXT_SHIFT;
+
+        if (next < 4) {
+            walk[current] = (walk[current] & ~WALK_NEXT_MASK) | ((next + 1) << WALK_NEXT_SHIFT);
+
+            // The outer walls are never removed, so an open wall always leads to another tile.
+            if (!((mazeCells[current] >> next) & 1)) {
+                size_t neighbor = current + offsets[next];
+                if (!(walk[neighbor] & WALK_VISITED)) {
+                    walk[neighbor] = WALK_VISITED | ((next + 2) & WALK_PARENT_MASK);
+                    current = neighbor;
+                    if (visit(context, current, ++depth)) {
+                        return depth;
+                    }
+                }
+            }
+        } else if (current == root) {
+            return -1;
+        } else {
+            current += offsets[walk[current] & WALK_PARENT_MASK];
+            depth--;
+        }
+    }
 }
 
 /**
@@ -141,56 +274,6 @@ int getWalls(int x, int y) {
     return result;
 }
 
-/**
- * Collects all tiles in the maze which have exactly 2 walls.
- * The function will then pick one at random, store the coordinates in the passed array, and return success or failure.
- *
- * Returns a 1 if there exists at least one branch point, and a 0 if not.
- *
- * @param coordArr Pointer to the selected branch point.
- * @return A boolean value stating whether a valid branch point was found or not.
- */
-int getRandomBranchPoint(int* coordArr) {
-    static int earliestX = 0, earliestY = 0;
-
-    int count = 0;
-    int coords[mazeWidth*mazeHeight][2];
-    int keepLocating = 1;
-
-    for (int x = earliestX; x < mazeWidth && keepLocating; x++) {
-        int y = 0;
-        if (x == earliestX) y = earliestY;
-        for (; y < mazeHeight && keepLocating; y++) {
-
-            if (isStartTile(x, y)) {
-                continue;
-            }
-
-            int wallCount = getWallCount(x, y);
-            if (getUnvisitedNeighbors(x, y) && (wallCount == 2 || wallCount == 3)) {
-                if (count == 0) {
-                    earliestX = x;
-                    earliestY = y;
-                }
-                coords[count][0] = x;
-                coords[count][1] = y;
-                count++;
-            }
-
-            keepLocating = (count < randomBranchLimit);
-        }
-    }
-
-    // If there are any valid new branch points, pick a random one, and store it in the passed array.
-    if (count) {
-        int randChoice = randInt(count);
-        coordArr[0] = coords[randChoice][0];
-        coordArr[1] = coords[randChoice][1];
-        return 1;
-    }
-    return 0;
-}
-
 int isStartTile(int x, int y) {
     return &mazeState[x][y] == startTile;
 }
@@ -9,6 +9,11 @@
 #ifndef MAZEGENERATOR_MAZE_DATA_H
 #define MAZEGENERATOR_MAZE_DATA_H
 
+#include <stddef.h>
+
+// The bits of a walkMaze() byte holding the direction back to the parent tile.
+#define WALK_PARENT_MASK 3
+
 enum Direction {
     NORTH = 0,
     EAST = 1,
@@ -20,19 +25,27 @@ enum State {
     ON = 1
 };
 
+typedef int (*WalkVisitor)(void* context, size_t tile, long long depth);
+
 
 void setTileWall(int x, int y, enum Direction direction, enum State state);
 void setAllTileWalls(int x, int y, enum State hasNorth, enum State hasEast, enum State hasSouth, enum State hasWest);
 
 void setStartTile(int x, int y);
 void setEndTile(int x, int y);
+void getStartTile(int* coordArr);
+void getEndTile(int* coordArr);
+void setSolutionLength(long long length);
+long long getSolutionLength();
+
+const unsigned char* getMazeCells();
+long long walkMaze(size_t root, unsigned char* walk, WalkVisitor visit, void* context);
 
 int getWall(int x, int y, enum Direction direction);
 int getWalls(int x, int y);
 int getWallCount(int x, int y);
 
 int getUnvisitedNeighbors(int x, int y);
-int getRandomBranchPoint(int* coordArr);
 
 void setCanBranch(int x, int y, enum State state);
 int getCanBranch(int x, int y);
@@ -9,6 +9,9 @@
 #include <stdio.h>
 #include "common.h"
 #include "maze_data.h"
+#include "analysis.h"
+#include "topology.h"
+#include "maze_API.h"
 #include "output.h"
 
 FILE* outfile;
@@ -17,6 +20,10 @@ void set_stream(FILE* stream) {
     outfile = stream;
 }
 
+FILE* get_stream() {
+    return outfile;
+}
+
 void open_file(char* fp) {
     set_stream(fopen(fp, "w"));
 }
@@ -62,28 +69,78 @@ void fPrintMaze() {
     fprintf(outfile, "\n");
 }
 
+/**
+ * Print every carved passage of a maze which isn't a grid, and so can't be drawn.
+ * The first line holds the cell count, passage count, start cell and end cell, followed by one line per passage
+ * holding the two cells it connects. Cells are numbered as laid out in topology.h.
+ */
+void fPrintPassages() {
+    const struct Topology* topology = getTopology();
+    int cells[2];
+    getStartEndCells(cells);
+
+    long long passageCount = 0;
+    for (int cell = 0; cell < topology->cellCount; cell++) {
+        passageCount += topology->degree[cell];
+    }
+
+    fprintf(outfile, "cells %d passages %lld start %d end %d\n",
+            topology->cellCount, passageCount / 2, cells[0], cells[1]);
+    for (int cell = 0; cell < topology->cellCount; cell++) {
+        for (size_t slot = topologyFirstSlot(topology, cell); slot < topologyEndSlot(topology, cell); slot++) {
+            if (topologyHasPassage(topology, slot) && topologyNeighbor(topology, slot) > cell) {
+                fprintf(outfile, "%d %d\n", cell, topologyNeighbor(topology, slot));
+            }
+        }
+    }
+}
+
+/**
+ * Print the difficulty metrics of the maze as a JSON object.
+ *
+ * @param analysis The metrics to print, as filled in by analyzeMaze().
+ */
+void fPrintAnalysis(const struct MazeAnalysis* analysis) {
+    fprintf(outfile, "{\n");
+    fprintf(outfile, "  \"width\": %d,\n", mazeWidth);
+    fprintf(outfile, "  \"height\": %d,\n", mazeHeight);
+    fprintf(outfile, "  \"dead_ends\": %lld,\n", analysis->deadEnds);
+    fprintf(outfile, "  \"junctions\": %lld,\n", analysis->junctions);
+    fprintf(outfile, "  \"solution_length\": %lld,\n", analysis->solutionLength);
+    fprintf(outfile, "  \"longest_corridor\": %d,\n", analysis->longestCorridor);
+    fprintf(outfile, "  \"branching_factor\": [%lld, %lld, %lld, %lld, %lld]\n",
+            analysis->branchingFactor[0], analysis->branchingFactor[1], analysis->branchingFactor[2],
+            analysis->branchingFactor[3], analysis->branchingFactor[4]);
+    fprintf(outfile, "}\n");
+}
+
+/**
+ * Looks up the ANSI escape sequence of the colour.
+ *
+ * @param colour The colour to look up.
+ * @return The escape sequence which switches the terminal to the colour.
+ */
+static const char* colourCode(enum colours colour) {
+    switch (colour) {
+        case RED:
+            return ANSI_COLOR_RED;
+        case GREEN:
+            return ANSI_COLOR_GREEN;
+        case YELLOW:
+            return ANSI_COLOR_YELLOW;
+        case BLUE:
+            return ANSI_COLOR_BLUE;
+        case MAGENTA:
+            return ANSI_COLOR_MAGENTA;
+        case CYAN:
+            return ANSI_COLOR_CYAN;
+    }
+    return "";
+}
+
 void cfprintf(FILE* stream, enum colours colour, char* stringToColour) {
     if (use_colours) {
-        switch (colour) {
-            case RED:
-                fprintf(stream, "%s", ANSI_COLOR_RED);
-                break;
-            case GREEN:
-                fprintf(stream, "%s", ANSI_COLOR_GREEN);
-                break;
-            case YELLOW:
-                fprintf(stream, "%s", ANSI_COLOR_YELLOW);
-                break;
-            case BLUE:
-                fprintf(stream, "%s", ANSI_COLOR_BLUE);
-                break;
-            case MAGENTA:
-                fprintf(stream, "%s", ANSI_COLOR_MAGENTA);
-                break;
-            case CYAN:
-                fprintf(stream, "%s", ANSI_COLOR_CYAN);
-                break;
-        }
+        fprintf(stream, "%s", colourCode(colour));
     }
 
     fprintf(stream, "%s", stringToColour);
@@ -91,4 +148,20 @@ void cfprintf(FILE* stream, enum colours colour, char* stringToColour) {
     if (use_colours) {
         fprintf(stream, "%s", ANSI_COLOR_RESET);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Works like cfprintf, but writes the (possibly coloured) string into a buffer instead of a stream.
+ * The buffer must have room for the string, the longest colour code, the reset code and a terminating null.
+ *
+ * @param buffer The buffer to write to.
+ * @param colour The colour of the string.
+ * @param stringToColour The string to write.
+ * @return The number of characters written, excluding the terminating null.
+ */
+int csprintf(char* buffer, enum colours colour, const char* stringToColour) {
+    if (use_colours) {
+        return sprintf(buffer, "%s%s%s", colourCode(colour), stringToColour, ANSI_COLOR_RESET);
+    }
+    return sprintf(buffer, "%s", stringToColour);
+}
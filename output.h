@@ -17,8 +17,13 @@ enum colours {
 };
 
 void set_stream(FILE* stream);
+FILE* get_stream();
 void open_file(char* fp);
 void fPrintMaze();
+void fPrintPassages();
+struct MazeAnalysis;
+void fPrintAnalysis(const struct MazeAnalysis* analysis);
 void cfprintf(FILE* stream, enum colours colour, char* stringToColour);
+int csprintf(char* buffer, enum colours colour, const char* stringToColour);
 
 #endif
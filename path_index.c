@@ -0,0 +1,485 @@
+/**
+ * Answers "how far apart are these two tiles" and "which way leads there" in constant time.
+ *
+ * A perfect maze is a tree, so the distance between two tiles is depth(a) + depth(b) - 2 * depth(lca),
+ * where lca is the lowest common ancestor of the tiles when the tree is rooted at the start tile.
+ * The tiles are numbered in the order a depth first walk first reaches them. For two tiles a and b,
+ * the shallowest tile numbered after a, up to and including b, is then a child of their lowest common ancestor.
+ * Picking the last such tile on ties makes it the child leading towards b, which also answers next-step queries.
+ *
+ * Finding the shallowest tile in a range is done by a sparse table over blocks of 32 positions, along with a bitmask
+ * per position recording which earlier positions in its block are still the minimum of some range ending there.
+ * This takes about 20 bytes per tile, and can be saved to a file which is later memory mapped instead of rebuilt.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "common.h"
+#include "maze_data.h"
+#include "path_index.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BLOCK_SIZE 32
+#define FILE_VERSION 1
+
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t root;
+    int32_t positionCount;
+    int32_t blockCount;
+    int32_t levelCount;
+};
+
+/**
+ * Works out where each array of the index is stored in an index file, each aligned to 8 bytes.
+ *
+ * @param header The header of the index.
+ * @param offsets Pointer to an array of 6 offsets, in the order the arrays are declared in struct PathIndex.
+ * @param sizes Pointer to an array of 6 sizes in bytes, in the same order.
+ * @return The total size of the file.
+ */
+static size_t fileLayout(const struct FileHeader* header, size_t* offsets, size_t* sizes) {
+    size_t cellCount = (size_t) header->width * header->height;
+    sizes[0] = cellCount * sizeof(int32_t);
+    sizes[1] = (size_t) header->positionCount * sizeof(int32_t);
+    sizes[2] = (size_t) header->positionCount * sizeof(int32_t);
+    sizes[3] = cellCount * sizeof(unsigned char);
+    sizes[4] = (size_t) header->positionCount * sizeof(uint32_t);
+    sizes[5] = (size_t) header->levelCount * header->blockCount * sizeof(int32_t);
+
+    size_t position = sizeof(struct FileHeader);
+    for (int i = 0; i < 6; i++) {
+        position = (position + 7) & ~(size_t) 7;
+        offsets[i] = position;
+        position += sizes[i];
+    }
+    return position;
+}
+
+static int floorLog2(unsigned int value) {
+    return 31 - __builtin_clz(value);
+}
+
+/**
+ * Checks that the sizes in a header agree with each other, as the queries index the arrays by them without checking.
+ * The contents of the arrays are trusted, as checking them would take as long as rebuilding the index.
+ */
+static int headerValid(const struct FileHeader* header) {
+    if (header->width <= 0 || header->height <= 0 || (long long) header->width * header->height > INT32_MAX) {
+        return 0;
+    }
+
+    // The root is always numbered, so an index has at least one position.
+    const int32_t cellCount = header->width * header->height;
+    return header->root >= 0 && header->root < cellCount
+        && header->positionCount >= 1 && header->positionCount <= cellCount
+        && header->blockCount == (header->positionCount + BLOCK_SIZE - 1) / BLOCK_SIZE
+        && header->levelCount == floorLog2((unsigned int) header->blockCount) + 1;
+}
+
+/**
+ * @return The tile leading from the cell towards the start tile.
+ */
+static int parentOf(const struct PathIndex* index, int cell) {
+    switch (index->parentDirection[cell]) {
+        case NORTH: return cell - 1;
+        case EAST: return cell + index->height;
+        case SOUTH: return cell + 1;
+        default: return cell - index->height;
+    }
+}
+
+/**
+ * Of two positions, picks the one with the shallower tile, preferring the later position on ties.
+ */
+static int32_t laterMinimum(const struct PathIndex* index, int32_t earlier, int32_t later) {
+    return index->depth[later] <= index->depth[earlier] ? later : earlier;
+}
+
+/**
+ * Finds the last position holding the shallowest tile between l and r, both inclusive and within one block.
+ */
+static int32_t blockMinimum(const struct PathIndex* index, int32_t l, int32_t r) {
+    uint32_t candidates = index->masks[r] & (~0u << (l % BLOCK_SIZE));
+    return (r - r % BLOCK_SIZE) + __builtin_ctz(candidates);
+}
+
+/**
+ * Finds the last position holding the shallowest tile between l and r, both inclusive.
+ */
+static int32_t rangeMinimum(const struct PathIndex* index, int32_t l, int32_t r) {
+    int32_t firstBlock = l / BLOCK_SIZE, lastBlock = r / BLOCK_SIZE;
+    if (firstBlock == lastBlock) {
+        return blockMinimum(index, l, r);
+    }
+
+    int32_t best = blockMinimum(index, l, firstBlock * BLOCK_SIZE + BLOCK_SIZE - 1);
+    if (firstBlock + 1 < lastBlock) {
+        int level = floorLog2((unsigned int) (lastBlock - firstBlock - 1));
+        const int32_t* row = index->sparse + (size_t) level * index->blockCount;
+        best = laterMinimum(index, best, row[firstBlock + 1]);
+        best = laterMinimum(index, best, row[lastBlock - (1 << level)]);
+    }
+    return laterMinimum(index, best, blockMinimum(index, lastBlock * BLOCK_SIZE, r));
+}
+
+/**
+ * Gives the tile the next position in the walk order, along with its depth.
+ */
+static int numberTile(void* context, size_t tile, long long depth) {
+    struct PathIndex* index = (struct PathIndex*) context;
+    index->preorder[tile] = index->positionCount;
+    index->order[index->positionCount] = (int32_t) tile;
+    index->depth[index->positionCount++] = (int32_t) depth;
+    return 0;
+}
+
+/**
+ * Numbers the tiles in the order a depth first walk from the root reaches them, and records the depth and parent
+ * of each. The walk keeps its state in the parent direction array itself, so it needs no stack.
+ */
+static void numberTiles(struct PathIndex* index) {
+    const long long cellCount = (long long) index->width * index->height;
+    unsigned char* walk = index->parentDirection;
+
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < cellCount; i++) {
+        index->preorder[i] = -1;
+        walk[i] = 0;
+    }
+
+    index->positionCount = 0;
+    walkMaze((size_t) index->root, walk, numberTile, index);
+
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < cellCount; i++) {
+        walk[i] &= WALK_PARENT_MASK;
+    }
+}
+
+/**
+ * Builds the range minimum tables over the depths of the numbered tiles.
+ */
+static void buildTables(struct PathIndex* index) {
+    const int blockCount = index->blockCount;
+    const int32_t positionCount = index->positionCount;
+
+    #pragma omp parallel for schedule(static)
+    for (int block = 0; block < blockCount; block++) {
+        const int32_t start = block * BLOCK_SIZE;
+        const int32_t end = start + BLOCK_SIZE < positionCount ? start + BLOCK_SIZE : positionCount;
+        int32_t stack[BLOCK_SIZE];
+        int top = 0;
+        uint32_t mask = 0;
+
+        // The stack holds the positions which are the minimum of some range ending at the current position.
+        for (int32_t i = start; i < end; i++) {
+            while (top && index->depth[stack[top - 1]] >= index->depth[i]) {
+                mask &= ~(1u << (stack[--top] - start));
+            }
+            stack[top++] = i;
+            mask |= 1u << (i - start);
+            index->masks[i] = mask;
+        }
+        index->sparse[block] = start + __builtin_ctz(index->masks[end - 1]);
+    }
+
+    for (int level = 1; level < index->levelCount; level++) {
+        const int32_t* previous = index->sparse + (size_t) (level - 1) * blockCount;
+        int32_t* row = index->sparse + (size_t) level * blockCount;
+        const int half = 1 << (level - 1);
+        const int rowLength = blockCount - 2 * half + 1;
+
+        #pragma omp parallel for schedule(static)
+        for (int block = 0; block < rowLength; block++) {
+            row[block] = laterMinimum(index, previous[block], previous[block + half]);
+        }
+    }
+}
+
+/**
+ * Builds the index over the current maze, rooted at the start tile.
+ * Tiles which can't be reached from the start tile are left out, and queries involving them return -1.
+ *
+ * @return Pointer to the index, or NULL if it could not be allocated.
+ */
+struct PathIndex* pathIndexBuild() {
+    struct PathIndex* index = (struct PathIndex*) calloc(1, sizeof(struct PathIndex));
+    if (index == NULL) {
+        return NULL;
+    }
+
+    int start[2];
+    getStartTile(start);
+    size_t cellCount = (size_t) mazeWidth * mazeHeight;
+    index->width = mazeWidth;
+    index->height = mazeHeight;
+    index->root = (int) ((size_t) start[0] * mazeHeight + start[1]);
+
+    index->preorder = (int32_t*) malloc(cellCount * sizeof(int32_t));
+    index->order = (int32_t*) malloc(cellCount * sizeof(int32_t));
+    index->depth = (int32_t*) malloc(cellCount * sizeof(int32_t));
+    index->parentDirection = (unsigned char*) malloc(cellCount * sizeof(unsigned char));
+    if (index->preorder == NULL || index->order == NULL || index->depth == NULL || index->parentDirection == NULL) {
+        pathIndexFree(index);
+        return NULL;
+    }
+
+    numberTiles(index);
+
+    index->blockCount = (index->positionCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    index->levelCount = floorLog2((unsigned int) index->blockCount) + 1;
+    index->masks = (uint32_t*) malloc(index->positionCount * sizeof(uint32_t));
+    // Higher levels leave the end of their row unused, which is zeroed so saved indexes don't depend on leftover memory.
+    index->sparse = (int32_t*) calloc((size_t) index->levelCount * index->blockCount, sizeof(int32_t));
+    if (index->masks == NULL || index->sparse == NULL) {
+        pathIndexFree(index);
+        return NULL;
+    }
+
+    buildTables(index);
+    return index;
+}
+
+void pathIndexFree(struct PathIndex* index) {
+    if (index == NULL) {
+        return;
+    }
+
+    if (index->mapping != NULL) {
+#ifdef _WIN32
+        UnmapViewOfFile(index->mapping);
+#else
+        munmap(index->mapping, index->mappingSize);
+#endif
+    } else {
+        free(index->preorder);
+        free(index->order);
+        free(index->depth);
+        free(index->parentDirection);
+        free(index->masks);
+        free(index->sparse);
+    }
+    free(index);
+}
+
+/**
+ * Writes the index to a binary file, which can be memory mapped by pathIndexMap().
+ *
+ * The file starts with the 4 bytes "CMZI", followed by the format version, width, height, root cell, number of
+ * reachable tiles, number of blocks and number of sparse table levels as 32-bit integers. The arrays of the index
+ * follow in the order they are declared in struct PathIndex, each aligned to 8 bytes.
+ * All integers use the byte order of the machine that wrote the file.
+ *
+ * @param index The index to save.
+ * @param filepath The path of the file to write.
+ * @return 1 if the file was written, and 0 if not.
+ */
+int pathIndexSave(const struct PathIndex* index, const char* filepath) {
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    struct FileHeader header = {{'C', 'M', 'Z', 'I'}, FILE_VERSION, index->width, index->height, index->root,
+                                index->positionCount, index->blockCount, index->levelCount};
+    size_t offsets[6], sizes[6];
+    fileLayout(&header, offsets, sizes);
+    const void* arrays[6] = {index->preorder, index->order, index->depth,
+                             index->parentDirection, index->masks, index->sparse};
+
+    static const char padding[8] = {0};
+    size_t written = sizeof(header);
+    int success = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int i = 0; i < 6 && success; i++) {
+        success = fwrite(padding, 1, offsets[i] - written, file) == offsets[i] - written
+               && fwrite(arrays[i], 1, sizes[i], file) == sizes[i];
+        written = offsets[i] + sizes[i];
+    }
+
+    return fclose(file) == 0 && success;
+}
+
+/**
+ * Maps an index file written by pathIndexSave() into memory, without reading it all up front.
+ * The index must be freed with pathIndexFree(), which also unmaps the file.
+ *
+ * @param filepath The path of the index file.
+ * @return Pointer to the index, or NULL if the file could not be mapped or is not a valid index.
+ */
+struct PathIndex* pathIndexMap(const char* filepath) {
+    void* mapping = NULL;
+    size_t mappingSize = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE fileMapping = NULL;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= (LONGLONG) sizeof(struct FileHeader)) {
+        fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    if (fileMapping != NULL) {
+        mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+        mappingSize = (size_t) fileSize.QuadPart;
+        CloseHandle(fileMapping);
+    }
+    CloseHandle(file);
+#else
+    int file = open(filepath, O_RDONLY);
+    if (file < 0) {
+        return NULL;
+    }
+    struct stat fileStats;
+    if (fstat(file, &fileStats) == 0 && fileStats.st_size >= (off_t) sizeof(struct FileHeader)) {
+        mappingSize = (size_t) fileStats.st_size;
+        mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = NULL;
+        }
+    }
+    close(file);
+#endif
+
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    struct PathIndex* index = (struct PathIndex*) calloc(1, sizeof(struct PathIndex));
+    const struct FileHeader* header = (const struct FileHeader*) mapping;
+    size_t offsets[6], sizes[6];
+    if (index == NULL || memcmp(header->magic, "CMZI", 4) != 0 || header->version != FILE_VERSION
+            || !headerValid(header) || fileLayout(header, offsets, sizes) > mappingSize) {
+        free(index);
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, mappingSize);
+#endif
+        return NULL;
+    }
+
+    char* base = (char*) mapping;
+    index->width = header->width;
+    index->height = header->height;
+    index->root = header->root;
+    index->positionCount = header->positionCount;
+    index->blockCount = header->blockCount;
+    index->levelCount = header->levelCount;
+    index->preorder = (int32_t*) (base + offsets[0]);
+    index->order = (int32_t*) (base + offsets[1]);
+    index->depth = (int32_t*) (base + offsets[2]);
+    index->parentDirection = (unsigned char*) (base + offsets[3]);
+    index->masks = (uint32_t*) (base + offsets[4]);
+    index->sparse = (int32_t*) (base + offsets[5]);
+    index->mapping = mapping;
+    index->mappingSize = mappingSize;
+    return index;
+}
+
+/**
+ * Finds the length of the path between two tiles.
+ * Both cells must be inside the maze, from 0 up to width * height, as they are not checked.
+ *
+ * @param index The index of the maze.
+ * @param from The cell of the first tile.
+ * @param to The cell of the second tile.
+ * @return The number of steps between the tiles, or -1 if either can't be reached from the start tile.
+ */
+int pathIndexDistance(const struct PathIndex* index, int from, int to) {
+    int32_t a = index->preorder[from], b = index->preorder[to];
+    if (a < 0 || b < 0) {
+        return -1;
+    }
+    if (a == b) {
+        return 0;
+    }
+
+    // The shallowest tile found is a child of the lowest common ancestor.
+    int32_t child = a < b ? rangeMinimum(index, a + 1, b) : rangeMinimum(index, b + 1, a);
+    return index->depth[a] + index->depth[b] - 2 * (index->depth[child] - 1);
+}
+
+/**
+ * Finds the first tile on the path from one tile to another.
+ * Both cells must be inside the maze, from 0 up to width * height, as they are not checked.
+ *
+ * @param index The index of the maze.
+ * @param from The cell of the tile the path starts on.
+ * @param to The cell of the tile the path ends on.
+ * @return The cell of the next tile on the path, the cell itself if both are the same,
+ *         or -1 if either can't be reached from the start tile.
+ */
+int pathIndexNextStep(const struct PathIndex* index, int from, int to) {
+    int32_t a = index->preorder[from], b = index->preorder[to];
+    if (a < 0 || b < 0) {
+        return -1;
+    }
+    if (a == b) {
+        return from;
+    }
+
+    // If the path goes down from the first tile, the child found is the one leading there. Otherwise, go up.
+    int32_t child = a < b ? rangeMinimum(index, a + 1, b) : rangeMinimum(index, b + 1, a);
+    int childCell = index->order[child];
+    return parentOf(index, childCell) == from ? childCell : parentOf(index, from);
+}
+
+/**
+ * Finds the distances between many pairs of tiles at once, spread across threads.
+ *
+ * @param index The index of the maze.
+ * @param from The cells the paths start on.
+ * @param to The cells the paths end on.
+ * @param distances Where the distances are stored, as returned by pathIndexDistance().
+ * @param count The number of pairs.
+ */
+void pathIndexDistanceBatch(const struct PathIndex* index, const int* from, const int* to, int* distances, size_t count) {
+    const long long pairCount = (long long) count;
+
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < pairCount; i++) {
+        distances[i] = pathIndexDistance(index, from[i], to[i]);
+    }
+}
+
+/**
+ * Finds the next steps of many paths at once, spread across threads.
+ *
+ * @param index The index of the maze.
+ * @param from The cells the paths start on.
+ * @param to The cells the paths end on.
+ * @param steps Where the next steps are stored, as returned by pathIndexNextStep().
+ * @param count The number of pairs.
+ */
+void pathIndexNextStepBatch(const struct PathIndex* index, const int* from, const int* to, int* steps, size_t count) {
+    const long long pairCount = (long long) count;
+
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < pairCount; i++) {
+        steps[i] = pathIndexNextStep(index, from[i], to[i]);
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * Header file for the path distance index.
+ *
+ * Cells are given by their index in getMazeCells(), so the tile at (x, y) is the cell x * height + y.
+ * The queries don't check their cells, so callers must keep them inside the maze.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_PATH_INDEX_H
+#define MAZEGENERATOR_PATH_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct PathIndex {
+    int width;
+    int height;
+    int root;
+    int positionCount;
+    int blockCount;
+    int levelCount;
+
+    int32_t* preorder;
+    int32_t* order;
+    int32_t* depth;
+    unsigned char* parentDirection;
+    uint32_t* masks;
+    int32_t* sparse;
+
+    void* mapping;
+    size_t mappingSize;
+};
+
+struct PathIndex* pathIndexBuild();
+void pathIndexFree(struct PathIndex* index);
+
+int pathIndexSave(const struct PathIndex* index, const char* filepath);
+struct PathIndex* pathIndexMap(const char* filepath);
+
+int pathIndexDistance(const struct PathIndex* index, int from, int to);
+int pathIndexNextStep(const struct PathIndex* index, int from, int to);
+void pathIndexDistanceBatch(const struct PathIndex* index, const int* from, const int* to, int* distances, size_t count);
+void pathIndexNextStepBatch(const struct PathIndex* index, const int* from, const int* to, int* steps, size_t count);
+
+#endif
@@ -8,10 +8,6 @@
 #include "common.h"
 #include "rng.h"
 
-#if DEBUG_LEVEL >= 4
-#include <stdio.h>
-#endif
-
 /**
  * Creates a random integer ranging from 0 inclusive to maxValue exclusive.
  *
@@ -28,9 +24,6 @@ int randInt(int maxValue) {
     int result;
     do {
         result = rand() % maxValue; // NOLINT(cert-msc30-c, cert-msc50-cpp)
-        #if DEBUG_LEVEL >= 4
-        printf("RNG result: %d", result);
-        #endif
     } while (result >= limit);
 
     return result % maxValue;
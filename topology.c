@@ -0,0 +1,371 @@
+/**
+ * Compiles cell graphs into a flat compressed sparse row form, so the generator can carve any shape of maze
+ * with the same code. A topology is described by a function listing the neighbours of a cell, which is called
+ * once to size the tables and once to fill them.
+ *
+ * The neighbours of every cell are listed in a fixed order, and for grids this is the order of enum Direction,
+ * so a grid carved through its topology picks the same random directions as it always has.
+ *
+ * Single layer grids are the common case, and are never compiled. Their neighbours are worked out from the tile index
+ * whenever they are needed, so a grid only costs its passage bits and a degree byte per tile.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "common.h"
+#include "maze_data.h"
+#include "topology.h"
+
+#define WORD_BITS 64
+
+// Adds a neighbour to the lists of a neighbour function, as long as it exists.
+#define ADD_NEIGHBOR(condition, neighbor, label) \
+    if (condition) { \
+        neighbors[count] = (neighbor); \
+        labels[count++] = (label); \
+    }
+
+struct GridContext {
+    int width;
+    int height;
+    int layers;
+};
+
+/**
+ * Lists the neighbours of a cell in a stack of grids.
+ */
+static int gridNeighbors(const void* context, int cell, int* neighbors, unsigned char* labels) {
+    const struct GridContext* grid = (const struct GridContext*) context;
+    const int plane = grid->width * grid->height;
+    const int layer = cell / plane, x = (cell % plane) / grid->height, y = cell % grid->height;
+    int count = 0;
+
+    ADD_NEIGHBOR(y > 0, cell - 1, NORTH)
+    ADD_NEIGHBOR(x + 1 < grid->width, cell + grid->height, EAST)
+    ADD_NEIGHBOR(y + 1 < grid->height, cell + 1, SOUTH)
+    ADD_NEIGHBOR(x > 0, cell - grid->height, WEST)
+    ADD_NEIGHBOR(layer > 0, cell - plane, TOPOLOGY_UP)
+    ADD_NEIGHBOR(layer + 1 < grid->layers, cell + plane, TOPOLOGY_DOWN)
+
+    return count;
+}
+
+/**
+ * Lists the neighbours of a cell in a hexagonal grid of flat-topped cells, where every odd column
+ * is shifted down by half a cell.
+ */
+static int hexNeighbors(const void* context, int cell, int* neighbors, unsigned char* labels) {
+    const struct GridContext* grid = (const struct GridContext*) context;
+    const int x = cell / grid->height, y = cell % grid->height;
+    const int h = grid->height;
+    int count = 0;
+
+    // The diagonal neighbours of an odd column lie half a cell lower than those of an even column.
+    const int upper = y - 1 + (x & 1), lower = y + (x & 1);
+
+    ADD_NEIGHBOR(y > 0, cell - 1, HEX_NORTH)
+    ADD_NEIGHBOR(x + 1 < grid->width && upper >= 0, cell + h + (upper - y), HEX_NORTH_EAST)
+    ADD_NEIGHBOR(x + 1 < grid->width && lower < h, cell + h + (lower - y), HEX_SOUTH_EAST)
+    ADD_NEIGHBOR(y + 1 < h, cell + 1, HEX_SOUTH)
+    ADD_NEIGHBOR(x > 0 && lower < h, cell - h + (lower - y), HEX_SOUTH_WEST)
+    ADD_NEIGHBOR(x > 0 && upper >= 0, cell - h + (upper - y), HEX_NORTH_WEST)
+
+    return count;
+}
+
+/**
+ * Compiles a cell graph into a topology with no passages carved.
+ *
+ * @param cellCount The number of cells in the graph.
+ * @param maxDegree The most neighbours any cell can have.
+ * @param neighborsOf Function which stores the neighbours of a cell and their labels, and returns how many there are.
+ * @param context Passed on to every call of neighborsOf.
+ * @return Pointer to the topology, or NULL if it could not be allocated.
+ */
+struct Topology* topologyCompile(int cellCount, int maxDegree, NeighborFunction neighborsOf, const void* context) {
+    struct Topology* topology = (struct Topology*) calloc(1, sizeof(struct Topology));
+    if (topology == NULL) {
+        return NULL;
+    }
+    topology->cellCount = cellCount;
+    topology->maxDegree = maxDegree;
+    topology->layers = 1;
+
+    topology->offsets = (size_t*) malloc((cellCount + 1) * sizeof(size_t));
+    if (topology->offsets == NULL) {
+        topologyFree(topology);
+        return NULL;
+    }
+
+    // Count the neighbours of every cell, then turn the counts into offsets.
+    topology->offsets[0] = 0;
+    #pragma omp parallel for schedule(static)
+    for (int cell = 0; cell < cellCount; cell++) {
+        int neighbors[maxDegree];
+        unsigned char labels[maxDegree];
+        topology->offsets[cell + 1] = neighborsOf(context, cell, neighbors, labels);
+    }
+    for (int cell = 0; cell < cellCount; cell++) {
+        topology->offsets[cell + 1] += topology->offsets[cell];
+    }
+
+    size_t slotCount = topology->offsets[cellCount];
+    topology->neighbors = (int*) malloc(slotCount * sizeof(int));
+    topology->labels = (unsigned char*) malloc(slotCount * sizeof(unsigned char));
+    topology->passages = (uint64_t*) calloc((slotCount + WORD_BITS - 1) / WORD_BITS, sizeof(uint64_t));
+    topology->degree = (unsigned char*) calloc(cellCount, sizeof(unsigned char));
+    if ((slotCount && (topology->neighbors == NULL || topology->labels == NULL || topology->passages == NULL))
+            || topology->degree == NULL) {
+        topologyFree(topology);
+        return NULL;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int cell = 0; cell < cellCount; cell++) {
+        size_t slot = topology->offsets[cell];
+        neighborsOf(context, cell, topology->neighbors + slot, topology->labels + slot);
+    }
+
+    return topology;
+}
+
+/**
+ * Checks that a maze of the given size has few enough cells to be numbered by an int.
+ */
+static int fitsCellCount(int width, int height, int layers) {
+    return width > 0 && height > 0 && layers > 0 && (long long) width * height * layers <= INT_MAX;
+}
+
+/**
+ * Creates a rectangular grid where each tile connects to the tiles orthogonal to it.
+ * The grid is implicit, so only the passage bits and degrees are allocated.
+ *
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param mask Which tiles are part of the maze, indexed like getMazeCells(), or NULL to include every tile.
+ *             The mask is not copied, so it must outlive the topology.
+ * @return Pointer to the topology, or NULL if it is too large or could not be allocated.
+ */
+struct Topology* topologyCreateGrid(int width, int height, const unsigned char* mask) {
+    if (!fitsCellCount(width, height, 1)) {
+        return NULL;
+    }
+
+    struct Topology* topology = (struct Topology*) calloc(1, sizeof(struct Topology));
+    if (topology == NULL) {
+        return NULL;
+    }
+    topology->kind = TOPOLOGY_GRID;
+    topology->width = width;
+    topology->height = height;
+    topology->layers = 1;
+    topology->cellCount = width * height;
+    topology->maxDegree = 4;
+    topology->mask = mask;
+
+    size_t slotCount = (size_t) topology->cellCount * 4;
+    topology->passages = (uint64_t*) calloc((slotCount + WORD_BITS - 1) / WORD_BITS, sizeof(uint64_t));
+    topology->degree = (unsigned char*) calloc(topology->cellCount, sizeof(unsigned char));
+    if (topology->passages == NULL || topology->degree == NULL) {
+        topologyFree(topology);
+        return NULL;
+    }
+    return topology;
+}
+
+/**
+ * Creates a hexagonal grid where each cell connects to up to 6 others, as laid out by enum HexDirection.
+ *
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @return Pointer to the topology, or NULL if it could not be allocated.
+ */
+struct Topology* topologyCreateHex(int width, int height) {
+    if (!fitsCellCount(width, height, 1)) {
+        return NULL;
+    }
+    struct GridContext grid = {width, height, 1};
+    struct Topology* topology = topologyCompile(width * height, 6, hexNeighbors, &grid);
+    if (topology != NULL) {
+        topology->kind = TOPOLOGY_HEX;
+        topology->width = width;
+        topology->height = height;
+    }
+    return topology;
+}
+
+/**
+ * Creates a stack of rectangular grids, where each tile also connects to the tiles directly above and below it.
+ *
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param layers The number of grids stacked on top of each other.
+ * @return Pointer to the topology, or NULL if it could not be allocated.
+ */
+struct Topology* topologyCreateLayered(int width, int height, int layers) {
+    if (!fitsCellCount(width, height, layers)) {
+        return NULL;
+    }
+    struct GridContext grid = {width, height, layers};
+    struct Topology* topology = topologyCompile(width * height * layers, 6, gridNeighbors, &grid);
+    if (topology != NULL) {
+        topology->kind = TOPOLOGY_LAYERED;
+        topology->width = width;
+        topology->height = height;
+        topology->layers = layers;
+    }
+    return topology;
+}
+
+void topologyFree(struct Topology* topology) {
+    if (topology == NULL) {
+        return;
+    }
+    free(topology->offsets);
+    free(topology->neighbors);
+    free(topology->labels);
+    free(topology->passages);
+    free(topology->degree);
+    free(topology);
+}
+
+/**
+ * Reads a mask from a text file, where each line is a row of the maze. Every '#' or 'X' marks a tile which is
+ * not part of the maze, and every other character marks a tile which is. Lines shorter than the longest line
+ * are treated as if they were padded with masked out tiles.
+ *
+ * @param filepath The path of the mask file.
+ * @param width Pointer to where the width of the mask is stored.
+ * @param height Pointer to where the height of the mask is stored.
+ * @return The mask, indexed like getMazeCells(), or NULL if it could not be read.
+ */
+unsigned char* topologyLoadMask(const char* filepath, int* width, int* height) {
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* text = (size > 0) ? (char*) malloc(size) : NULL;
+    if (text == NULL || fread(text, 1, size, file) != (size_t) size) {
+        free(text);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+
+    // Measure the mask first, ignoring carriage returns and a missing newline at the end.
+    int rows = 0, columns = 0, lineLength = 0;
+    for (long i = 0; i <= size; i++) {
+        if (i == size || text[i] == '\n') {
+            if (lineLength > 0 || i < size) rows++;
+            if (lineLength > columns) columns = lineLength;
+            lineLength = 0;
+        } else if (text[i] != '\r') {
+            lineLength++;
+        }
+    }
+
+    unsigned char* mask = (rows && columns) ? (unsigned char*) calloc((size_t) rows * columns, 1) : NULL;
+    if (mask != NULL) {
+        int x = 0, y = 0;
+        for (long i = 0; i < size; i++) {
+            if (text[i] == '\n') {
+                x = 0;
+                y++;
+            } else if (text[i] != '\r') {
+                mask[(size_t) x * rows + y] = text[i] != '#' && text[i] != 'X';
+                x++;
+            }
+        }
+        *width = columns;
+        *height = rows;
+    }
+
+    free(text);
+    return mask;
+}
+
+/**
+ * Carves the passage in the given slot, along with the slot leading back from the neighbour.
+ *
+ * @param topology The topology to carve in.
+ * @param cell The cell the slot belongs to.
+ * @param slot The slot of the passage.
+ * @return The neighbour the passage leads to.
+ */
+int topologyCarve(struct Topology* topology, int cell, size_t slot) {
+    int neighbor = topologyNeighbor(topology, slot);
+    size_t back = topologyFindSlot(topology, neighbor, cell);
+
+    topology->passages[slot / WORD_BITS] |= (uint64_t) 1 << (slot % WORD_BITS);
+    topology->passages[back / WORD_BITS] |= (uint64_t) 1 << (back % WORD_BITS);
+    topology->degree[cell]++;
+    topology->degree[neighbor]++;
+    return neighbor;
+}
+
+/**
+ * Finds the slot of a cell which leads to the given neighbour.
+ *
+ * @return The slot, or (size_t) -1 if the cells are not neighbours.
+ */
+size_t topologyFindSlot(const struct Topology* topology, int cell, int neighbor) {
+    for (size_t slot = topologyFirstSlot(topology, cell); slot < topologyEndSlot(topology, cell); slot++) {
+        if (topologyNeighbor(topology, slot) == neighbor) {
+            return slot;
+        }
+    }
+    return (size_t) -1;
+}
+
+/**
+ * Counts the groups of cells which are connected through their neighbours, ignoring whether passages are carved.
+ * A cell which is part of the maze, but has no neighbours, is a group of its own.
+ *
+ * Only grids can have cells which aren't part of the maze, as given by their mask.
+ *
+ * @return The number of groups, or -1 if there wasn't enough memory to count them.
+ */
+int topologyCountRegions(const struct Topology* topology) {
+    int* queue = (int*) malloc(topology->cellCount * sizeof(int));
+    unsigned char* seen = (unsigned char*) calloc(topology->cellCount, sizeof(unsigned char));
+    if (queue == NULL || seen == NULL) {
+        free(queue);
+        free(seen);
+        return -1;
+    }
+
+    int regions = 0;
+    for (int first = 0; first < topology->cellCount; first++) {
+        if (seen[first] || (topology->mask != NULL && !topology->mask[first])) {
+            continue;
+        }
+
+        regions++;
+        int head = 0, tail = 0;
+        queue[tail++] = first;
+        seen[first] = 1;
+        while (head < tail) {
+            int cell = queue[head++];
+            for (size_t slot = topologyFirstSlot(topology, cell); slot < topologyEndSlot(topology, cell); slot++) {
+                int neighbor = topologyNeighbor(topology, slot);
+                if (neighbor != TOPOLOGY_NO_NEIGHBOR && !seen[neighbor]) {
+                    seen[neighbor] = 1;
+                    queue[tail++] = neighbor;
+                }
+            }
+        }
+    }
+
+    free(queue);
+    free(seen);
+    return regions;
+}
@@ -0,0 +1,160 @@
+/**
+ * Header file for the cell topologies the maze can be generated over.
+ *
+ * Cells are numbered column by column, then layer by layer, so the cell at (x, y, layer) has the index
+ * (layer * width + x) * height + y. For a single layer grid, this is the same order as getMazeCells().
+ * The cell count must fit in an int, so the topology constructors return NULL for anything larger.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_TOPOLOGY_H
+#define MAZEGENERATOR_TOPOLOGY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum TopologyKind {
+    TOPOLOGY_GRID = 0,
+    TOPOLOGY_HEX = 1,
+    TOPOLOGY_LAYERED = 2
+};
+
+// Labels of the passages leading between layers. Passages within a layer use enum Direction.
+#define TOPOLOGY_UP 4
+#define TOPOLOGY_DOWN 5
+
+enum HexDirection {
+    HEX_NORTH = 0,
+    HEX_NORTH_EAST = 1,
+    HEX_SOUTH_EAST = 2,
+    HEX_SOUTH = 3,
+    HEX_SOUTH_WEST = 4,
+    HEX_NORTH_WEST = 5
+};
+
+// Returned by topologyNeighbor() for slots which don't lead anywhere, such as the edge of a grid.
+#define TOPOLOGY_NO_NEIGHBOR -1
+
+/**
+ * A cell graph, where the neighbours of a cell are found in the slots topologyFirstSlot() up to, but not including,
+ * topologyEndSlot(). Each slot has a neighbour, a label telling which direction the neighbour lies in,
+ * and a bit in the passage bitset which is set once the passage is carved.
+ *
+ * Grids are implicit: every tile has 4 slots, one per enum Direction, and the neighbours are worked out from the
+ * tile index instead of being stored. Other topologies are compiled into compressed sparse row form, where the
+ * slots of a cell are offsets[cell] up to offsets[cell + 1].
+ */
+struct Topology {
+    enum TopologyKind kind;
+    int width;
+    int height;
+    int layers;
+    int cellCount;
+    int maxDegree;
+
+    const unsigned char* mask;
+    size_t* offsets;
+    int* neighbors;
+    unsigned char* labels;
+    uint64_t* passages;
+    unsigned char* degree;
+};
+
+typedef int (*NeighborFunction)(const void* context, int cell, int* neighbors, unsigned char* labels);
+
+struct Topology* topologyCompile(int cellCount, int maxDegree, NeighborFunction neighborsOf, const void* context);
+struct Topology* topologyCreateGrid(int width, int height, const unsigned char* mask);
+struct Topology* topologyCreateHex(int width, int height);
+struct Topology* topologyCreateLayered(int width, int height, int layers);
+void topologyFree(struct Topology* topology);
+
+unsigned char* topologyLoadMask(const char* filepath, int* width, int* height);
+
+int topologyCarve(struct Topology* topology, int cell, size_t slot);
+size_t topologyFindSlot(const struct Topology* topology, int cell, int neighbor);
+int topologyCountRegions(const struct Topology* topology);
+
+// The accessors below are used in the innermost loops of the generator, so they are kept inline.
+
+static inline size_t topologyFirstSlot(const struct Topology* topology, int cell) {
+    return topology->offsets ? topology->offsets[cell] : (size_t) cell * 4;
+}
+
+static inline size_t topologyEndSlot(const struct Topology* topology, int cell) {
+    return topology->offsets ? topology->offsets[cell + 1] : (size_t) cell * 4 + 4;
+}
+
+static inline unsigned char topologyLabel(const struct Topology* topology, size_t slot) {
+    return topology->offsets ? topology->labels[slot] : (unsigned char) (slot % 4);
+}
+
+/**
+ * Stores the neighbour behind every slot of the cell, in slot order, using TOPOLOGY_NO_NEIGHBOR for slots which
+ * lead out of the grid or into a masked out tile. Listing them all at once only works out the row of a grid tile once.
+ *
+ * @param neighbors Pointer to an array of at least maxDegree integers.
+ * @return The number of slots of the cell.
+ */
+static inline int topologyNeighborsOf(const struct Topology* topology, int cell, int* neighbors) {
+    if (topology->offsets) {
+        const size_t first = topology->offsets[cell];
+        const int count = (int) (topology->offsets[cell + 1] - first);
+        for (int i = 0; i < count; i++) {
+            neighbors[i] = topology->neighbors[first + i];
+        }
+        return count;
+    }
+
+    const int height = topology->height, y = cell % height;
+    const unsigned char* mask = topology->mask;
+    neighbors[0] = y > 0 ? cell - 1 : TOPOLOGY_NO_NEIGHBOR;
+    neighbors[1] = cell < topology->cellCount - height ? cell + height : TOPOLOGY_NO_NEIGHBOR;
+    neighbors[2] = y + 1 < height ? cell + 1 : TOPOLOGY_NO_NEIGHBOR;
+    neighbors[3] = cell >= height ? cell - height : TOPOLOGY_NO_NEIGHBOR;
+
+    if (mask != NULL) {
+        for (int i = 0; i < 4; i++) {
+            if (!mask[cell] || (neighbors[i] != TOPOLOGY_NO_NEIGHBOR && !mask[neighbors[i]])) {
+                neighbors[i] = TOPOLOGY_NO_NEIGHBOR;
+            }
+        }
+    }
+    return 4;
+}
+
+/**
+ * @return The cell the slot leads to, or TOPOLOGY_NO_NEIGHBOR if it leads out of the grid or into a masked out tile.
+ */
+static inline int topologyNeighbor(const struct Topology* topology, size_t slot) {
+    if (topology->offsets) {
+        return topology->neighbors[slot];
+    }
+
+    int neighbors[4];
+    topologyNeighborsOf(topology, (int) (slot / 4), neighbors);
+    return neighbors[slot % 4];
+}
+
+/**
+ * @return How many neighbours the cell has, which is 0 for cells that aren't part of the maze.
+ */
+static inline int topologyNeighborCount(const struct Topology* topology, int cell) {
+    if (topology->offsets) {
+        return (int) (topology->offsets[cell + 1] - topology->offsets[cell]);
+    }
+
+    int neighbors[4], count = 0;
+    for (int i = 0; i < topologyNeighborsOf(topology, cell, neighbors); i++) {
+        count += neighbors[i] != TOPOLOGY_NO_NEIGHBOR;
+    }
+    return count;
+}
+
+static inline int topologyHasPassage(const struct Topology* topology, size_t slot) {
+    return (int) ((topology->passages[slot / 64] >> (slot % 64)) & 1);
+}
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * Records timestamped events while the program runs, and writes them out as a Chrome trace
+ * (viewable in chrome://tracing or Perfetto) once the program exits.
+ *
+ * Every thread records into its own ring buffer, so recording never takes a lock. Once a ring buffer is full,
+ * the oldest events are overwritten. Phase events are kept apart from the ring, in a small buffer which drops
+ * new events once it is full, so the outline of the run survives no matter how many detail events follow.
+ * The ring buffers are linked together the first time each thread records an event, which only needs a compare-and-swap.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "common.h"
+#include "trace.h"
+
+// Must be a power of 2. Each event takes up 32 bytes.
+#define TRACE_RING_CAPACITY (1 << 16)
+#define TRACE_PHASE_CAPACITY 256
+
+struct TraceEvent {
+    uint64_t timestamp;
+    const char* name;
+    int x;
+    int y;
+    char phase;
+};
+
+struct TraceRing {
+    struct TraceEvent events[TRACE_RING_CAPACITY];
+    _Atomic uint64_t head;
+    struct TraceEvent phases[TRACE_PHASE_CAPACITY];
+    _Atomic uint64_t phaseCount;
+    int threadId;
+    struct TraceRing* next;
+};
+
+int trace_enabled = 0;
+
+static char traceFilepath[256];
+static uint64_t traceStartTime;
+static _Atomic(struct TraceRing*) rings;
+static atomic_int threadCount;
+static _Thread_local struct TraceRing* localRing;
+
+/**
+ * @return The current time in nanoseconds.
+ */
+static uint64_t now() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/**
+ * Creates the ring buffer of the calling thread, and links it into the list of ring buffers.
+ *
+ * @return The ring buffer, or NULL if it could not be allocated.
+ */
+static struct TraceRing* registerRing() {
+    struct TraceRing* ring = (struct TraceRing*) calloc(1, sizeof(struct TraceRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    ring->threadId = atomic_fetch_add(&threadCount, 1);
+    ring->next = atomic_load(&rings);
+    while (!atomic_compare_exchange_weak(&rings, &ring->next, ring));
+
+    localRing = ring;
+    return ring;
+}
+
+/**
+ * Writes a single event to the trace file, as an element of the traceEvents array.
+ */
+static void writeEvent(FILE* file, const struct TraceEvent* event, int threadId, int first) {
+    uint64_t elapsed = event->timestamp - traceStartTime;
+
+    fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%d",
+            first ? "" : ",", event->name, event->phase,
+            (unsigned long long) (elapsed / 1000), (unsigned int) (elapsed % 1000), threadId);
+    if (event->phase == 'i') {
+        fprintf(file, ",\"s\":\"t\"");
+    }
+    if (event->x != TRACE_NO_COORD) {
+        fprintf(file, ",\"args\":{\"x\":%d,\"y\":%d}", event->x, event->y);
+    }
+    fprintf(file, "}");
+}
+
+/**
+ * Writes every recorded event to the trace file. Registered to run when the program exits.
+ * The phase events and the ring of each thread are merged by time. An end event whose begin event
+ * was overwritten in the ring is left out, so no event ends without having begun.
+ */
+static void traceExport() {
+    FILE* file = fopen(traceFilepath, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Could not write trace to %s\n", traceFilepath);
+        return;
+    }
+
+    fprintf(file, "{\"traceEvents\":[");
+    int first = 1;
+    for (struct TraceRing* ring = atomic_load(&rings); ring != NULL; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t tail = head > TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : 0;
+        uint64_t phaseCount = atomic_load_explicit(&ring->phaseCount, memory_order_acquire);
+        uint64_t phase = 0;
+        int depth = 0;
+
+        for (uint64_t i = tail; i < head || phase < phaseCount;) {
+            const struct TraceEvent* event = i < head ? &ring->events[i & (TRACE_RING_CAPACITY - 1)] : NULL;
+
+            if (phase < phaseCount && (event == NULL || ring->phases[phase].timestamp <= event->timestamp)) {
+                writeEvent(file, &ring->phases[phase++], ring->threadId, first);
+                first = 0;
+                continue;
+            }
+            i++;
+
+            if (event->phase == 'B') {
+                depth++;
+            } else if (event->phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                depth--;
+            }
+            writeEvent(file, event, ring->threadId, first);
+            first = 0;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+}
+
+/**
+ * Enables tracing, and makes the trace get written to the given file when the program exits.
+ *
+ * @param filepath The path of the trace file.
+ * @return 1 if tracing was enabled, and 0 if not.
+ */
+int traceStart(const char* filepath) {
+    snprintf(traceFilepath, sizeof(traceFilepath), "%s", filepath);
+    traceStartTime = now();
+
+    if (atexit(traceExport) != 0) {
+        return 0;
+    }
+    trace_enabled = 1;
+    return 1;
+}
+
+/**
+ * Records an event for the calling thread. Use the TRACE_* macros instead of calling this directly.
+ *
+ * @param phase The Chrome trace phase of the event: 'B' for begin, 'E' for end, or 'i' for instant.
+ * @param name The name of the event. Must be a string literal, as only the pointer is kept.
+ * @param x The 0-indexed column the event concerns, or TRACE_NO_COORD.
+ * @param y The 0-indexed row the event concerns, or TRACE_NO_COORD.
+ * @param level TRACE_PHASE for the few events outlining the run, which are never overwritten,
+ *              or TRACE_DETAIL for events which go into the ring buffer.
+ */
+void traceRecord(char phase, const char* name, int x, int y, enum TraceLevel level) {
+    struct TraceRing* ring = localRing;
+    if (ring == NULL && (ring = registerRing()) == NULL) {
+        return;
+    }
+
+    struct TraceEvent* event;
+    _Atomic uint64_t* head;
+    uint64_t index;
+    if (level == TRACE_PHASE) {
+        head = &ring->phaseCount;
+        index = atomic_load_explicit(head, memory_order_relaxed);
+        if (index == TRACE_PHASE_CAPACITY) {
+            return;
+        }
+        event = &ring->phases[index];
+    } else {
+        head = &ring->head;
+        index = atomic_load_explicit(head, memory_order_relaxed);
+        event = &ring->events[index & (TRACE_RING_CAPACITY - 1)];
+    }
+
+    event->timestamp = now();
+    event->name = name;
+    event->x = x;
+    event->y = y;
+    event->phase = phase;
+    atomic_store_explicit(head, index + 1, memory_order_release);
+}
@@ -0,0 +1,37 @@
+/**
+ * Header file for the runtime tracing.
+ *
+ * The macros only cost a single branch while tracing is disabled, so they can be left in release builds.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_TRACE_H
+#define MAZEGENERATOR_TRACE_H
+
+#define TRACE_NO_COORD -1
+
+enum TraceLevel {
+    TRACE_PHASE = 0,
+    TRACE_DETAIL = 1
+};
+
+#define TRACE_EVENT(phase, name, x, y, level) do { if (trace_enabled) traceRecord(phase, name, x, y, level); } while (0)
+
+// Detail events, such as single path segments, which may be overwritten once there are too many of them.
+#define TRACE_BEGIN(name, x, y) TRACE_EVENT('B', name, x, y, TRACE_DETAIL)
+#define TRACE_END(name) TRACE_EVENT('E', name, TRACE_NO_COORD, TRACE_NO_COORD, TRACE_DETAIL)
+#define TRACE_INSTANT(name, x, y) TRACE_EVENT('i', name, x, y, TRACE_DETAIL)
+
+// Phase events, which outline the run and are always kept.
+#define TRACE_PHASE_BEGIN(name) TRACE_EVENT('B', name, TRACE_NO_COORD, TRACE_NO_COORD, TRACE_PHASE)
+#define TRACE_PHASE_END(name) TRACE_EVENT('E', name, TRACE_NO_COORD, TRACE_NO_COORD, TRACE_PHASE)
+
+extern int trace_enabled;
+
+int traceStart(const char* filepath);
+void traceRecord(char phase, const char* name, int x, int y, enum TraceLevel level);
+
+#endif
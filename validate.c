@@ -0,0 +1,231 @@
+/**
+ * Verifies that the maze is perfect, meaning every tile can be reached, and there is exactly one path between
+ * any two tiles. The check runs in close to O(W*H) using a union-find over the tiles.
+ *
+ * The maze is split into bands of columns which are joined in parallel, since no union inside a band can touch a tile
+ * outside of it. The passages crossing from one band into the next are joined afterwards, merging neighbouring groups
+ * of bands in parallel rounds.
+ *
+ * Mazes without a wall state, or with masked out tiles, are checked over the passages of their topology instead.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "common.h"
+#include "maze_data.h"
+#include "validate.h"
+#include "trace.h"
+#include "topology.h"
+
+// The maze is split into at most this many bands, independent of the thread count, so the result never depends on it.
+#define BAND_COUNT 64
+
+// Every tile points at a tile with a lower or equal index, so the root of a set is always its lowest tile.
+struct UnionFind {
+    uint32_t* parent;
+};
+
+/**
+ * Joins the sets containing the two tiles, using Rem's algorithm with splicing.
+ * Both paths are climbed at once, always on the side whose parent is higher, and every tile climbed past is moved
+ * under the lower parent. The climb stops as soon as both sides share a parent, which is usually well before
+ * reaching the root. No ranks are kept, as the splicing keeps the paths short in practice.
+ *
+ * @return 1 if the tiles were in different sets, and 0 if the passage closes a cycle.
+ */
+static int join(struct UnionFind* uf, uint32_t a, uint32_t b) {
+    uint32_t* parent = uf->parent;
+    while (parent[a] != parent[b]) {
+        if (parent[a] < parent[b]) {
+            uint32_t swap = a;
+            a = b;
+            b = swap;
+        }
+
+        if (parent[a] == a) {
+            parent[a] = parent[b];
+            return 1;
+        }
+        uint32_t up = parent[a];
+        parent[a] = parent[b];
+        a = up;
+    }
+    return 0;
+}
+
+/**
+ * Checks that the markers point at tiles inside the maze, and that they are different tiles.
+ */
+static int markersValid() {
+    int start[2], end[2];
+    getStartTile(start);
+    getEndTile(end);
+
+    return start[0] >= 0 && start[0] < mazeWidth && start[1] >= 0 && start[1] < mazeHeight
+        && end[0] >= 0 && end[0] < mazeWidth && end[1] >= 0 && end[1] < mazeHeight
+        && (start[0] != end[0] || start[1] != end[1]);
+}
+
+/**
+ * Checks whether the current maze is perfect. The maze is perfect when:
+ * <ul>
+ *  <li>Both sides of every wall agree on its state, and no outer wall is open.</li>
+ *  <li>There are exactly one fewer passages than tiles, and no passage closes a cycle.</li>
+ *  <li>Every tile is connected to every other tile.</li>
+ *  <li>The start and end tiles are distinct tiles inside the maze.</li>
+ * </ul>
+ *
+ * @param result Pointer to the struct the details of the check get stored in.
+ * @return 1 if the maze is perfect, 0 if not, and -1 if there wasn't enough memory to check.
+ */
+int validateMaze(struct MazeValidation* result) {
+    const unsigned char* cells = getMazeCells();
+    const int width = mazeWidth, height = mazeHeight;
+    const long long tileCount = (long long) width * height;
+    const int bandCount = width < BAND_COUNT ? width : BAND_COUNT;
+
+    struct UnionFind uf;
+    uf.parent = (uint32_t*) malloc(tileCount * sizeof(uint32_t));
+    if (uf.parent == NULL) {
+        return -1;
+    }
+
+    long long passages = 0, joins = 0, mismatched = 0, openOuter = 0;
+
+    #pragma omp parallel for schedule(dynamic, 1) reduction(+:passages, joins, mismatched, openOuter)
+    for (int band = 0; band < bandCount; band++) {
+        const int firstX = (int) ((long long) width * band / bandCount);
+        const int lastX = (int) ((long long) width * (band + 1) / bandCount);
+        TRACE_BEGIN("validate band", firstX, 0);
+
+        for (long long i = (long long) firstX * height; i < (long long) lastX * height; i++) {
+            uf.parent[i] = (uint32_t) i;
+        }
+
+        for (int x = firstX; x < lastX; x++) {
+            for (int y = 0; y < height; y++) {
+                const uint32_t tile = (uint32_t) ((long long) x * height + y);
+                const unsigned char walls = cells[tile];
+
+                if (y == 0) openOuter += !((walls >> NORTH) & 1);
+                if (x == 0) openOuter += !((walls >> WEST) & 1);
+
+                if (y + 1 == height) {
+                    openOuter += !((walls >> SOUTH) & 1);
+                } else if (((walls >> SOUTH) & 1) != ((cells[tile + 1] >> NORTH) & 1)) {
+                    mismatched++;
+                } else if (!((walls >> SOUTH) & 1)) {
+                    passages++;
+                    joins += join(&uf, tile, tile + 1);
+                }
+
+                // Passages into the next band are counted here, but joined once every band is done.
+                if (x + 1 == width) {
+                    openOuter += !((walls >> EAST) & 1);
+                } else if (((walls >> EAST) & 1) != ((cells[tile + height] >> WEST) & 1)) {
+                    mismatched++;
+                } else if (!((walls >> EAST) & 1)) {
+                    passages++;
+                    if (x + 1 < lastX) joins += join(&uf, tile, tile + height);
+                }
+            }
+        }
+        TRACE_END("validate band");
+    }
+
+    // Neighbouring groups of bands are merged pairwise, doubling the group size each round. A join only ever touches
+    // tiles in the two groups it merges, so the pairs of one round can be merged in parallel.
+    for (int groupSize = 1; groupSize < bandCount; groupSize *= 2) {
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:joins)
+        for (int band = groupSize; band < bandCount; band += 2 * groupSize) {
+            const int x = (int) ((long long) width * band / bandCount) - 1;
+            for (int y = 0; y < height; y++) {
+                const uint32_t tile = (uint32_t) ((long long) x * height + y);
+                if (!((cells[tile] >> EAST) & 1) && !((cells[tile + height] >> WEST) & 1)) {
+                    joins += join(&uf, tile, tile + height);
+                }
+            }
+        }
+    }
+
+    free(uf.parent);
+
+    result->passages = passages;
+    result->components = tileCount - joins;
+    result->cycles = passages - joins;
+    result->mismatchedWalls = mismatched;
+    result->openOuterWalls = openOuter;
+    result->markersValid = markersValid();
+
+    return result->passages == tileCount - 1
+        && result->components == 1
+        && result->cycles == 0
+        && result->mismatchedWalls == 0
+        && result->openOuterWalls == 0
+        && result->markersValid;
+}
+
+/**
+ * Checks whether the maze carved over the given topology is perfect, using the same rules as validateMaze().
+ * Cells without any neighbours, such as masked out tiles, are not part of the maze and are left out of the check.
+ * A passage is mismatched when it is only carved from one of its two cells, and there are no outer walls to open.
+ *
+ * @param topology The topology the maze was carved over.
+ * @param startCell The cell holding the start of the maze.
+ * @param endCell The cell holding the end of the maze.
+ * @param result Pointer to the struct the details of the check get stored in.
+ * @return 1 if the maze is perfect, 0 if not, and -1 if there wasn't enough memory to check.
+ */
+int validateTopology(const struct Topology* topology, int startCell, int endCell, struct MazeValidation* result) {
+    struct UnionFind uf;
+    uf.parent = (uint32_t*) malloc(topology->cellCount * sizeof(uint32_t));
+    if (uf.parent == NULL) {
+        return -1;
+    }
+
+    long long cellCount = 0, passages = 0, joins = 0, mismatched = 0;
+    for (int cell = 0; cell < topology->cellCount; cell++) {
+        uf.parent[cell] = (uint32_t) cell;
+        cellCount += topologyNeighborCount(topology, cell) > 0;
+    }
+
+    for (int cell = 0; cell < topology->cellCount; cell++) {
+        for (size_t slot = topologyFirstSlot(topology, cell); slot < topologyEndSlot(topology, cell); slot++) {
+            const int neighbor = topologyNeighbor(topology, slot);
+            if (neighbor < cell) {
+                continue;
+            }
+
+            const size_t back = topologyFindSlot(topology, neighbor, cell);
+            const int carved = topologyHasPassage(topology, slot);
+            if (back == (size_t) -1 || carved != topologyHasPassage(topology, back)) {
+                mismatched++;
+            } else if (carved) {
+                passages++;
+                joins += join(&uf, (uint32_t) cell, (uint32_t) neighbor);
+            }
+        }
+    }
+
+    free(uf.parent);
+
+    result->passages = passages;
+    result->components = cellCount - joins;
+    result->cycles = passages - joins;
+    result->mismatchedWalls = mismatched;
+    result->openOuterWalls = 0;
+    result->markersValid = startCell >= 0 && startCell < topology->cellCount
+        && endCell >= 0 && endCell < topology->cellCount && startCell != endCell
+        && topologyNeighborCount(topology, startCell) > 0
+        && topologyNeighborCount(topology, endCell) > 0;
+
+    return result->passages == cellCount - 1
+        && result->components == 1
+        && result->cycles == 0
+        && result->mismatchedWalls == 0
+        && result->markersValid;
+}
@@ -0,0 +1,26 @@
+/**
+ * Header file for the perfect maze validator.
+ *
+ * @author Datskalf
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef MAZEGENERATOR_VALIDATE_H
+#define MAZEGENERATOR_VALIDATE_H
+
+struct Topology;
+
+struct MazeValidation {
+    long long passages;
+    long long components;
+    long long cycles;
+    long long mismatchedWalls;
+    long long openOuterWalls;
+    int markersValid;
+};
+
+int validateMaze(struct MazeValidation* result);
+int validateTopology(const struct Topology* topology, int startCell, int endCell, struct MazeValidation* result);
+
+#endif